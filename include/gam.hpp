@@ -40,7 +40,10 @@
 #include "gam/Context.hpp"  //ctx
 #include "gam/GlobalPointer.hpp"
 #include "gam/TrackingAllocator.hpp"
+#include "gam/atomic_ptr.hpp"
 #include "gam/defs.hpp"
+#include "gam/global_array.hpp"
+#include "gam/global_unordered_map.hpp"
 #include "gam/private_ptr.hpp"
 #include "gam/public_ptr.hpp"
 
@@ -57,6 +60,17 @@ static inline executor_id rank() { return ctx().rank(); }
 
 static inline executor_id cardinality() { return ctx().cardinality(); }
 
+/**
+ * @brief returns a snapshot of the local memory usage
+ *
+ * Usage is reported by type of allocated blocks, by access level of
+ * committed objects and by author of local copies of public objects.
+ * See Accounting::print for a human-readable dump.
+ */
+static inline Accounting::report memory_usage() {
+  return ctx().memory_usage();
+}
+
 } /* namespace gam */
 
 #endif /* GAM_HPP_ */
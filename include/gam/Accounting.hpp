@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       implements Accounting class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_ACCOUNTING_HPP_
+#define INCLUDE_GAM_ACCOUNTING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include "gam/defs.hpp"
+
+namespace gam {
+
+/**
+ * TypeRegistry assigns small dense slots to the types of accounted objects.
+ * Slot 0 collects untyped blocks, as well as types beyond max_types.
+ */
+class TypeRegistry {
+ public:
+  static constexpr unsigned max_types = 128;
+  static constexpr unsigned untyped = 0;
+
+  static TypeRegistry &instance() {
+    /* constructed in place, never destroyed */
+    static typename std::aligned_storage<sizeof(TypeRegistry),
+                                         alignof(TypeRegistry)>::type storage;
+    static TypeRegistry *res = new (&storage) TypeRegistry();
+    return *res;
+  }
+
+  unsigned add(const char *name) {
+    std::lock_guard<std::mutex> lg(mtx);
+    if (n == max_types) return untyped;
+    names[n] = name;
+    return n++;
+  }
+
+  unsigned size() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return n;
+  }
+
+  /*
+   * human-readable name of the type in a slot
+   */
+  std::string name(unsigned slot) {
+    const char *res;
+    {
+      std::lock_guard<std::mutex> lg(mtx);
+      res = names[slot];
+    }
+#ifdef __GNUG__
+    int status;
+    char *d = abi::__cxa_demangle(res, nullptr, nullptr, &status);
+    if (d) {
+      std::string s(d);
+      std::free(d);
+      return s;
+    }
+#endif
+    return res;
+  }
+
+ private:
+  std::mutex mtx;
+  const char *names[max_types] = {"(untyped)"};
+  unsigned n = 1;
+
+  TypeRegistry() {}
+};
+
+template <typename T>
+unsigned type_slot() {
+  static const unsigned res = TypeRegistry::instance().add(typeid(T).name());
+  return res;
+}
+
+/**
+ * live objects and bytes
+ */
+struct usage {
+  long long objects = 0, bytes = 0;
+};
+
+/**
+ * Accounting keeps live memory usage of the process:
+ * - blocks served by the wrapped allocator, by type (bytes are footprints)
+ * - committed objects, by access level (bytes are object sizes)
+ * - local copies of public objects, by author (bytes are footprints)
+ *
+ * Counters are spread over cache-aligned shards, each thread updating its
+ * own shard with relaxed atomic operations, so that accounting takes no lock
+ * and causes little contention.
+ * Sampling sums up the shards, thus it is consistent only in quiescence.
+ *
+ * The instance is never destroyed, as the allocators it accounts for.
+ */
+class Accounting {
+ public:
+  static constexpr unsigned n_shards = 16;
+
+  static Accounting &instance() {
+    /* constructed in place, never destroyed */
+    static typename std::aligned_storage<sizeof(Accounting),
+                                         alignof(Accounting)>::type storage;
+    static Accounting *res = new (&storage) Accounting();
+    return *res;
+  }
+
+  Accounting(const Accounting &) = delete;
+  Accounting &operator=(const Accounting &) = delete;
+
+  /*
+   * enable accounting by author, for executors in [0, cardinality)
+   */
+  void init_authors(executor_id cardinality) {
+    std::lock_guard<std::mutex> lg(authors_mtx);
+    if (n_authors.load(std::memory_order_relaxed)) return;
+    for (auto &s : shards) {
+      s.authors.reset(new cell[cardinality]);
+      for (executor_id i = 0; i < cardinality; ++i) s.authors[i].clear();
+    }
+    n_authors.store(cardinality, std::memory_order_release);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * updates
+   *
+   ***************************************************************************
+   */
+  void alloc(unsigned type, size_t bytes) { shard().types[type].add(1, bytes); }
+
+  void free(unsigned type, size_t bytes) {
+    shard().types[type].add(-1, -(long long)bytes);
+  }
+
+  void commit(AccessLevel al, size_t bytes) {
+    shard().levels[al].add(1, bytes);
+  }
+
+  void release(AccessLevel al, size_t bytes) {
+    shard().levels[al].add(-1, -(long long)bytes);
+  }
+
+  void copy(executor_id author, size_t bytes) {
+    if (author < n_authors.load(std::memory_order_acquire))
+      shard().authors[author].add(1, bytes);
+  }
+
+  void free_copy(executor_id author, size_t bytes) {
+    if (author < n_authors.load(std::memory_order_acquire))
+      shard().authors[author].add(-1, -(long long)bytes);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * sampling
+   *
+   ***************************************************************************
+   */
+  /**
+   * a snapshot of live memory usage
+   */
+  struct report {
+    usage total;                                      // all blocks
+    usage levels[2];                                  // by AccessLevel
+    std::vector<std::pair<std::string, usage>> types;  // non-empty types
+    std::vector<usage> authors;                       // by author
+
+    bool empty() const {
+      return !total.objects && !levels[AL_PUBLIC].objects &&
+             !levels[AL_PRIVATE].objects;
+    }
+  };
+
+  report sample() {
+    report res;
+    unsigned nt = TypeRegistry::instance().size();
+    executor_id na = n_authors.load(std::memory_order_acquire);
+    res.authors.resize(na);
+
+    for (unsigned t = 0; t < nt; ++t) {
+      usage u;
+      for (auto &s : shards) s.types[t].load_into(u);
+      res.total.objects += u.objects;
+      res.total.bytes += u.bytes;
+      if (u.objects || u.bytes)
+        res.types.emplace_back(TypeRegistry::instance().name(t), u);
+    }
+
+    for (auto &s : shards) {
+      s.levels[AL_PUBLIC].load_into(res.levels[AL_PUBLIC]);
+      s.levels[AL_PRIVATE].load_into(res.levels[AL_PRIVATE]);
+      for (executor_id i = 0; i < na; ++i)
+        s.authors[i].load_into(res.authors[i]);
+    }
+
+    return res;
+  }
+
+  static void print(std::ostream &os, const report &r) {
+    os << "total: " << r.total.objects << " blocks, " << r.total.bytes
+       << " bytes\n";
+    os << "committed public: " << r.levels[AL_PUBLIC].objects << " objects, "
+       << r.levels[AL_PUBLIC].bytes << " bytes\n";
+    os << "committed private: " << r.levels[AL_PRIVATE].objects
+       << " objects, " << r.levels[AL_PRIVATE].bytes << " bytes\n";
+    for (executor_id i = 0; i < r.authors.size(); ++i)
+      if (r.authors[i].objects)
+        os << "copies from " << i << ": " << r.authors[i].objects
+           << " objects, " << r.authors[i].bytes << " bytes\n";
+    for (auto &t : r.types)
+      os << "type " << t.first << ": " << t.second.objects << " blocks, "
+         << t.second.bytes << " bytes\n";
+  }
+
+ private:
+  struct cell {
+    std::atomic<long long> objects, bytes;
+
+    cell() { clear(); }
+
+    void clear() {
+      objects.store(0, std::memory_order_relaxed);
+      bytes.store(0, std::memory_order_relaxed);
+    }
+
+    void add(long long o, long long b) {
+      objects.fetch_add(o, std::memory_order_relaxed);
+      bytes.fetch_add(b, std::memory_order_relaxed);
+    }
+
+    void load_into(usage &u) const {
+      u.objects += objects.load(std::memory_order_relaxed);
+      u.bytes += bytes.load(std::memory_order_relaxed);
+    }
+  };
+
+  struct alignas(64) shard_t {
+    cell types[TypeRegistry::max_types];
+    cell levels[2];
+    std::unique_ptr<cell[]> authors;
+  };
+
+  shard_t shards[n_shards];
+  std::atomic<executor_id> n_authors{0};
+  std::mutex authors_mtx;
+  std::atomic<unsigned> next_shard{0};
+
+  Accounting() {}
+
+  shard_t &shard() {
+    static thread_local int idx = -1;
+    if (idx < 0)
+      idx = next_shard.fetch_add(1, std::memory_order_relaxed) % n_shards;
+    return shards[idx];
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_ACCOUNTING_HPP_ */
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       CPU and NUMA affinity of the executor
+ *
+ * @ingroup internals
+ *
+ * Affinity is configured by the following environment variables, typically
+ * assigned per rank by the launcher:
+ * - GAM_NUMA_NODE: the NUMA node local memory is preferably allocated from;
+ *   it also defaults the CPU sets below to the CPUs of the node
+ * - GAM_CPUS_USER: the CPUs user threads are pinned to (e.g., "0-3,8")
+ * - GAM_CPUS_DAEMON: the CPUs the daemon thread is pinned to
+ *
+ * Only the thread constructing the executor context is pinned as user
+ * thread, threads spawned afterwards inherit its affinity.
+ */
+#ifndef INCLUDE_GAM_AFFINITY_HPP_
+#define INCLUDE_GAM_AFFINITY_HPP_
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "gam/Logger.hpp"
+
+namespace gam {
+
+/*
+ * parse a CPU list (e.g., "0-3,8") into a CPU set
+ */
+static inline bool parse_cpu_list(const char *s, cpu_set_t &set) {
+  CPU_ZERO(&set);
+  char *end;
+  while (*s) {
+    unsigned long first = strtoul(s, &end, 10), last = first;
+    if (end == s) return false;
+    s = end;
+    if (*s == '-') {
+      last = strtoul(++s, &end, 10);
+      if (end == s || last < first) return false;
+      s = end;
+    }
+    for (unsigned long c = first; c <= last && c < CPU_SETSIZE; ++c)
+      CPU_SET(c, &set);
+    if (*s == ',')
+      ++s;
+    else if (*s && *s != '\n')
+      return false;
+    else
+      break;
+  }
+  return CPU_COUNT(&set) > 0;
+}
+
+/*
+ * the CPUs of a NUMA node, as exposed by sysfs
+ */
+static inline bool numa_node_cpus(int node, cpu_set_t &set) {
+  std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) +
+                  "/cpulist");
+  std::string l;
+  if (!std::getline(f, l)) return false;
+  return parse_cpu_list(l.c_str(), set);
+}
+
+static inline bool pin_this_thread(const cpu_set_t &set) {
+  return !pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+}
+
+struct affinity_config {
+  int numa_node = -1;
+  bool pin_user = false, pin_daemon = false;
+  cpu_set_t user_cpus, daemon_cpus;
+
+  static affinity_config from_env() {
+    affinity_config res;
+    CPU_ZERO(&res.user_cpus);
+    CPU_ZERO(&res.daemon_cpus);
+    char *env, *tmp;
+
+    env = std::getenv("GAM_NUMA_NODE");
+    if (env && *env) {
+      long node = strtol(env, &tmp, 10);
+      if (tmp != env && node >= 0) {
+        res.numa_node = (int)node;
+        if (numa_node_cpus(res.numa_node, res.user_cpus)) {
+          res.daemon_cpus = res.user_cpus;
+          res.pin_user = res.pin_daemon = true;
+        }
+      } else
+        LOGLN("AFF ignoring malformed GAM_NUMA_NODE=%s", env);
+    }
+
+    env = std::getenv("GAM_CPUS_USER");
+    if (env && *env) {
+      res.pin_user = parse_cpu_list(env, res.user_cpus);
+      if (!res.pin_user) LOGLN("AFF ignoring malformed GAM_CPUS_USER=%s", env);
+    }
+
+    env = std::getenv("GAM_CPUS_DAEMON");
+    if (env && *env) {
+      res.pin_daemon = parse_cpu_list(env, res.daemon_cpus);
+      if (!res.pin_daemon)
+        LOGLN("AFF ignoring malformed GAM_CPUS_DAEMON=%s", env);
+    }
+
+    return res;
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_AFFINITY_HPP_ */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @brief       implements AtomicDirectory class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_ATOMICDIRECTORY_HPP_
+#define INCLUDE_GAM_ATOMICDIRECTORY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace gam {
+
+/**
+ * AtomicDirectory is an array of atomic pointers that grows on demand and
+ * never shrinks, backing the segmented tables indexed by dense offsets.
+ *
+ * Readers never lock. Writers (i.e., grow and store) must be serialized by
+ * the owner, that also owns the items.
+ * Replaced arrays are retired rather than freed, since concurrent readers may
+ * be still traversing them, and released upon destruction.
+ */
+template <typename E>
+class AtomicDirectory {
+ public:
+  AtomicDirectory() : cur(new array(1)) {}
+
+  ~AtomicDirectory() {
+    delete cur.load(std::memory_order_relaxed);
+    for (auto a : retired) delete a;
+  }
+
+  AtomicDirectory(const AtomicDirectory &) = delete;
+  AtomicDirectory &operator=(const AtomicDirectory &) = delete;
+
+  /*
+   * the number of items, that never decreases
+   */
+  size_t size() const { return cur.load(std::memory_order_acquire)->size; }
+
+  /*
+   * the i-th item, or nullptr if not set
+   */
+  E *load(size_t i) const {
+    array *a = cur.load(std::memory_order_acquire);
+    return i < a->size ? a->items[i].load(std::memory_order_acquire) : nullptr;
+  }
+
+  /*
+   * the i-th item, growing the directory if needed (writers only)
+   */
+  E *grow(size_t i) {
+    array *a = cur.load(std::memory_order_relaxed);
+    if (i >= a->size) {
+      size_t n = a->size;
+      while (n <= i) n *= 2;
+      array *a_ = new array(n);
+      for (size_t j = 0; j < a->size; ++j)
+        a_->items[j].store(a->items[j].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+      cur.store(a_, std::memory_order_release);
+      retired.push_back(a);
+      a = a_;
+    }
+    return a->items[i].load(std::memory_order_relaxed);
+  }
+
+  /*
+   * publish the i-th item, the directory being grown past i (writers only)
+   */
+  void store(size_t i, E *e) {
+    cur.load(std::memory_order_relaxed)
+        ->items[i]
+        .store(e, std::memory_order_release);
+  }
+
+ private:
+  struct array {
+    size_t size;
+    std::atomic<E *> *items;
+
+    explicit array(size_t n) : size(n), items(new std::atomic<E *>[n]) {
+      for (size_t i = 0; i < n; ++i)
+        items[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~array() { delete[] items; }
+  };
+
+  std::atomic<array *> cur;
+  std::vector<array *> retired;
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_ATOMICDIRECTORY_HPP_ */
@@ -29,7 +29,6 @@
  *
  * @ingroup     internals
  *
- * @todo remote-load by RMA operations + remote memory allocation
  * @todo move local memory management to a dedicated module
  * @todo friendly error reporting
  * @todo define thread-safeness for each function
@@ -41,18 +40,26 @@
 #include <cassert>
 #include <cstdlib>
 #include <cstring>  //memcpy
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#include "gam/Accounting.hpp"
+#include "gam/Affinity.hpp"
 #include "gam/GlobalPointer.hpp"
 #include "gam/Logger.hpp"
 #include "gam/MemoryController.hpp"
 #include "gam/View.hpp"
+#include "gam/active_message.hpp"
 #include "gam/backend_ptr.hpp"
 #include "gam/defs.hpp"
 #include "gam/links_stub.hpp"
+#include "gam/registry.hpp"
 #include "gam/wrapped_allocator.hpp"
 
 #ifdef CONNECTION_LINKS
@@ -96,6 +103,7 @@ class Context {
     assert(env);
     rank_ = strtoull(env, &tmp, 10);
     assert(rank_ <= GlobalPointer::max_home);
+    addresses.home(rank_);
 
     /*
      * initialize logger
@@ -112,6 +120,20 @@ class Context {
     LOGLN("CTX cardinality = %llu", cardinality_);
     assert(cardinality_ <= GlobalPointer::max_home + 1);
 
+    pap_pending.resize(cardinality_);
+    accounting.init_authors(cardinality_);
+
+    /*
+     * apply affinity settings from env
+     */
+    affinity = affinity_config::from_env();
+    if (affinity.numa_node >= 0) {
+      LOGLN("CTX numa node = %d", affinity.numa_node);
+      RegisteredArena::instance().bind_node(affinity.numa_node);
+    }
+    if (affinity.pin_user && !pin_this_thread(affinity.user_cpus))
+      LOGLN("CTX could not pin user thread");
+
     /*
      * read node and service names from env
      */
@@ -141,13 +163,13 @@ class Context {
     /*
      * initialize links
      */
-    Links<pap_pointer>::init_links(node.host);
+    Links<pap_message>::init_links(node.host);
 
     /*
      * create links
      */
     pap_links =
-        new Links<pap_pointer>(cardinality_, rank_, nodes[rank_].svc_pap);
+        new Links<pap_message>(cardinality_, rank_, nodes[rank_].svc_pap);
     local_links =
         new Links<daemon_pointer>(cardinality_, rank_, nodes[rank_].svc_local);
     remote_links =
@@ -165,6 +187,8 @@ class Context {
                            nodes[i].svc_local);  // send rload rep
       }
     }
+    local_links->peer(rank_, nodes[rank_].host,
+                      nodes[rank_].svc_remote);  // fabric atomics on self
 
     /*
      * init links
@@ -202,7 +226,17 @@ class Context {
     delete local_links;
     delete remote_links;
 
-    Links<pap_pointer>::fini_links();
+    Links<pap_message>::fini_links();
+
+    /*
+     * report memory still in use
+     */
+    Accounting::report r = accounting.sample();
+    if (!r.empty()) {
+      std::cerr << "> memory still in use at teardown of executor " << rank_
+                << ":\n";
+      Accounting::print(std::cerr, r);
+    }
 
     /*
      * finalize logger
@@ -214,6 +248,11 @@ class Context {
 
   executor_id cardinality() const { return cardinality_; }
 
+  /*
+   * a snapshot of live local memory usage
+   */
+  Accounting::report memory_usage() { return accounting.sample(); }
+
   /*
    ***************************************************************************
    *
@@ -226,14 +265,10 @@ class Context {
    */
   template <class T, typename Deleter>
   GlobalPointer mmap_public(T &lp, Deleter d) {
-    GlobalPointer res = mmap_global<AL_PUBLIC>(&lp, d);
-    uint64_t a = res.address();
-
     /* initialize owner and child fields with void values */
-    view.bind_owner(a, (executor_id)GlobalPointer::max_home + 1);
-    view.bind_child(a, nullptr);
-
-    return res;
+    return mmap_global<AL_PUBLIC>(&lp, d,
+                                  (executor_id)GlobalPointer::max_home + 1,
+                                  nullptr);
   }
 
   /*
@@ -241,33 +276,76 @@ class Context {
    */
   template <class T, typename Deleter>
   GlobalPointer mmap_private(T &lp, Deleter d) {
-    GlobalPointer res = mmap_global<AL_PRIVATE>(&lp, d);
-    uint64_t a = res.address();
+    GlobalPointer res = mmap_global<AL_PRIVATE>(&lp, d, rank_, &lp);
 
-    /* update owner */
-    view.bind_owner(a, rank_);
+    /* update parenthood information */
+    bind_parent(&lp, res.address(), allocated_locally(d));
+
+    return res;
+  }
+
+  /*
+   * construct an object in place, along with its backend, and map a fresh
+   * global address (for public memory) to it
+   */
+  template <class T, typename... Params>
+  GlobalPointer mmap_public_new(Params... p) {
+    auto bp = local_new<backend_inline_ptr<T>>(p...);
+    return mmap_backend<AL_PUBLIC>(bp, (executor_id)GlobalPointer::max_home + 1,
+                                   nullptr, false);
+  }
+
+  /*
+   * construct an object in place, along with its backend, and map a fresh
+   * global address (for private memory) to it
+   */
+  template <class T, typename... Params>
+  GlobalPointer mmap_private_new(Params... p) {
+    auto bp = local_new<backend_inline_ptr<T>>(p...);
+    T *child = bp->typed_get();
+    GlobalPointer res = mmap_backend<AL_PRIVATE>(bp, rank_, child, true);
 
     /* update parenthood information */
-    view.bind_parent(&lp, a);
-    view.bind_child(a, &lp);
+    bind_parent(child, res.address(), true);
 
     return res;
   }
 
+  /*
+   * remote allocation: construct an object in place on executor e, from
+   * shippable arguments, and map a fresh global address (authored by e) to
+   * it. Public memory is referenced once on behalf of the caller, private
+   * memory is owned by the caller.
+   */
+  template <class T, typename... Params>
+  GlobalPointer mmap_public_on(executor_id e, Params... p) {
+    return construct_on<AL_PUBLIC, T>(e, p...);
+  }
+
+  template <class T, typename... Params>
+  GlobalPointer mmap_private_on(executor_id e, Params... p) {
+    return construct_on<AL_PRIVATE, T>(e, p...);
+  }
+
   void unmap(const GlobalPointer &p) {
     assert(p.is_address());
     LOGLN_OS("CTX unmapping p=" << p);
-    uint64_t a = p.address();
+    View::entry e = view.unmap_record(p.address());
 
     /* clean up parenthood */
-    if (view.access_level(a) == AL_PRIVATE) {
-      assert(view.has_child(a));
-      assert(view.has_parent(view.child(a)));
-      view.unbind_parent(view.child(a));
+    if (e.access_level == AL_PRIVATE) {
+      assert(e.child != nullptr);
+      unbind_parent(e.child, e.linked);
     } else
-      assert(!view.has_child(a));
+      assert(e.child == nullptr);
+
+    /* finally release committed memory */
+    assert(e.committed != nullptr);
+    accounting.release(e.access_level, e.committed->size());
+    local_delete(e.committed);
 
-    munmap(p);
+    /* authors are home for their addresses, so the address can be recycled */
+    addresses.release(p);
   }
 
   /*
@@ -279,32 +357,35 @@ class Context {
    */
   inline void push_public(const GlobalPointer &p, const executor_id e) {
     assert(p.is_address());
-    uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PUBLIC);
+    View::entry r = view.record(p.address());
+    assert(r.access_level == AL_PUBLIC);
     LOGLN_OS("CTX push public=" << p << " to=" << e);
 
     pap_pointer buf;
     buf.p = p;
     buf.al = AL_PUBLIC;
-    buf.author = view.author(a);
-    pap_links->send(buf, e);
+    buf.author = r.author;
+    send_pap(&buf, 1, e);
   }
 
   inline void push_private(const GlobalPointer &p, const executor_id e) {
     assert(p.is_address());
     LOGLN_OS("CTX push private=" << p << " to=" << e);
-    uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PRIVATE);
-    assert(view.owner(a) == rank_);
-
-    /* switch ownership */
-    view.bind_owner(a, e);
-
     pap_pointer buf;
     buf.p = p;
     buf.al = AL_PRIVATE;
-    buf.author = view.author(a);
-    pap_links->send(buf, e);
+
+    /* switch ownership */
+    view.update(p.address(), [&](View::entry &r) {
+      assert(r.access_level == AL_PRIVATE);
+      assert(r.owner == rank_);
+      r.owner = e;
+      buf.author = r.author;
+    });
+    send_pap(&buf, 1, e);
+
+    /* only the author needs to keep track of passed-through addresses */
+    if (buf.author != rank_) view.unmap(p.address());
   }
 
   inline void push_reserved(const GlobalPointer &p, const executor_id e) {
@@ -313,7 +394,61 @@ class Context {
 
     pap_pointer buf;
     buf.p = p;
-    pap_links->send(buf, e);
+    send_pap(&buf, 1, e);
+  }
+
+  /*
+   * push a batch of public addresses (and reserved values) in as few messages
+   * as possible
+   */
+  void push_public_batch(const GlobalPointer *ps, size_t n,
+                         const executor_id e) {
+    LOGLN("CTX push public batch size=%zu to=%lu", n, e);
+
+    std::vector<pap_pointer> bufs(n);
+    for (size_t i = 0; i < n; ++i) {
+      bufs[i].p = ps[i];
+      if (ps[i].is_address()) {
+        View::entry r = view.record(ps[i].address());
+        assert(r.access_level == AL_PUBLIC);
+        bufs[i].al = AL_PUBLIC;
+        bufs[i].author = r.author;
+      }
+    }
+
+    send_pap(bufs.data(), n, e);
+  }
+
+  /*
+   * push a batch of private addresses (and reserved values) in as few messages
+   * as possible
+   */
+  void push_private_batch(const GlobalPointer *ps, size_t n,
+                          const executor_id e) {
+    LOGLN("CTX push private batch size=%zu to=%lu", n, e);
+
+    std::vector<pap_pointer> bufs(n);
+    for (size_t i = 0; i < n; ++i) {
+      bufs[i].p = ps[i];
+      if (ps[i].is_address()) {
+        bufs[i].al = AL_PRIVATE;
+
+        /* switch ownership */
+        view.update(ps[i].address(), [&](View::entry &r) {
+          assert(r.access_level == AL_PRIVATE);
+          assert(r.owner == rank_);
+          r.owner = e;
+          bufs[i].author = r.author;
+        });
+      }
+    }
+
+    send_pap(bufs.data(), n, e);
+
+    /* only the author needs to keep track of passed-through addresses */
+    for (size_t i = 0; i < n; ++i)
+      if (ps[i].is_address() && bufs[i].author != rank_)
+        view.unmap(ps[i].address());
   }
 
   /*
@@ -322,8 +457,7 @@ class Context {
   inline GlobalPointer pull_public(const executor_id e) {
     LOGLN_OS("CTX pull public from=" << e);
 
-    pap_pointer buf;
-    pap_links->recv(buf, e);
+    pap_pointer buf = pap_pop(e);
 
     /* ensure a public pointer was pulled */
     if (!buf.p.is_address() || buf.al == AL_PUBLIC) return pulled_public(buf);
@@ -339,8 +473,7 @@ class Context {
   inline GlobalPointer pull_public() {
     LOGLN_OS("CTX pull public from any");
 
-    pap_pointer buf;
-    pap_links->recv(buf);
+    pap_pointer buf = pap_pop();
 
     /* ensure a public pointer was pulled */
     if (!buf.p.is_address() || buf.al == AL_PUBLIC) return pulled_public(buf);
@@ -355,8 +488,7 @@ class Context {
    */
   inline GlobalPointer pull_private(const executor_id e) {
     LOGLN_OS("CTX pull private from=" << e);
-    pap_pointer buf;
-    pap_links->recv(buf, e);
+    pap_pointer buf = pap_pop(e);
 
     /* ensure a private pointer was pulled */
     if (!buf.p.is_address() || buf.al == AL_PRIVATE) return pulled_private(buf);
@@ -371,8 +503,7 @@ class Context {
    */
   inline GlobalPointer pull_private() {
     LOGLN_OS("CTX pull private from any");
-    pap_pointer buf;
-    pap_links->recv(buf);
+    pap_pointer buf = pap_pop();
 
     /* ensure a private pointer was pulled */
     if (!buf.p.is_address() || buf.al == AL_PRIVATE) return pulled_private(buf);
@@ -382,6 +513,60 @@ class Context {
     return GlobalPointer();
   }
 
+  /*
+   * blocking pull a batch of public addresses from specific executor
+   *
+   * It blocks until at least one address is available, then returns up to max
+   * addresses without further blocking.
+   */
+  inline std::vector<GlobalPointer> pull_public_batch(const executor_id e,
+                                                      size_t max) {
+    LOGLN("CTX pull public batch max=%zu from=%lu", max, e);
+    std::vector<GlobalPointer> res;
+
+    if (pap_pending[e].empty()) pap_fill(e);
+    while (res.size() < max && !pap_pending[e].empty()) {
+      pap_pointer buf = pap_pending[e].front();
+      pap_pending[e].pop_front();
+
+      /* ensure a public pointer was pulled */
+      if (!buf.p.is_address() || buf.al == AL_PUBLIC)
+        res.push_back(pulled_public(buf));
+      else
+        std::cerr << "> pull_public_batch() pulled a non-public pointer: \n"
+                  << buf.p << std::endl;
+    }
+
+    return res;
+  }
+
+  /*
+   * blocking pull a batch of private addresses from specific executor
+   *
+   * It blocks until at least one address is available, then returns up to max
+   * addresses without further blocking.
+   */
+  inline std::vector<GlobalPointer> pull_private_batch(const executor_id e,
+                                                       size_t max) {
+    LOGLN("CTX pull private batch max=%zu from=%lu", max, e);
+    std::vector<GlobalPointer> res;
+
+    if (pap_pending[e].empty()) pap_fill(e);
+    while (res.size() < max && !pap_pending[e].empty()) {
+      pap_pointer buf = pap_pending[e].front();
+      pap_pending[e].pop_front();
+
+      /* ensure a private pointer was pulled */
+      if (!buf.p.is_address() || buf.al == AL_PRIVATE)
+        res.push_back(pulled_private(buf));
+      else
+        std::cerr << "> pull_private_batch() pulled a non-private pointer: \n"
+                  << buf.p << std::endl;
+    }
+
+    return res;
+  }
+
   /*
    ***************************************************************************
    *
@@ -397,20 +582,25 @@ class Context {
     assert(p.is_address());
 
     LOGLN_OS("CTX local public " << p);
-    uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PUBLIC);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
 
     /* allocate local memory */
     T *lp = (T *)local_new<T>();
+    local_allocator.tag_copy(lp, e.author);
 
     /* load either locally or remotely */
-    if (view.author(a) == rank_)
-      local_load(lp, a);
+    if (e.author == rank_)
+      local_load(lp, e.committed);
     else
-      forward_load(lp, p);
+      forward_load(lp, p, e.author);
 
-    /* generate a smart pointer with custom deleter to match allocation */
-    return std::shared_ptr<T>((T *)lp, [](T *p_) { DELETE(p_); });
+    /*
+     * generate a smart pointer with custom deleter to match allocation, and
+     * control block from the same allocator
+     */
+    return std::shared_ptr<T>((T *)lp, [](T *p_) { DELETE(p_); },
+                              local_allocator.std_allocator_for<T>());
   }
 
   template <typename T>
@@ -419,17 +609,18 @@ class Context {
     assert(p.is_address());
 
     LOGLN_OS("CTX local public " << p);
-    uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PUBLIC);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
 
     /* allocate local memory */
     T *lp = (T *)local_new<T>();
+    local_allocator.tag_copy(lp, e.author);
 
     /* load either locally or remotely */
-    if (view.author(a) == rank_)
-      local_load(lp, a);
+    if (e.author == rank_)
+      local_load(lp, e.committed);
     else
-      forward_load(lp, p);
+      forward_load(lp, p, e.author);
 
     /* generate a smart pointer with custom deleter to match allocation */
     return std::unique_ptr<T, void (*)(T *)>((T *)lp,
@@ -437,24 +628,326 @@ class Context {
   }
 
   /*
-   * local_private returns the pointer associated to (private) global address
+   * borrow_public returns the committed object behind a locally-authored
+   * public address, pinned by an extra reference, or nullptr if the address
+   * is authored remotely.
+   * The caller holds a reference, thus the object cannot vanish meanwhile.
    */
   template <typename T>
-  T *local_private(const GlobalPointer &p) {
+  const T *borrow_public(const GlobalPointer &p) {
     assert(p.is_address());
+
     uint64_t a = p.address();
-    LOGLN_OS("CTX local private " << p);
-    assert(view.access_level(a) == AL_PRIVATE);
+    View::entry e = view.record(a);
+    assert(e.access_level == AL_PUBLIC);
+    if (e.author != rank_) return nullptr;
+
+    LOGLN_OS("CTX borrow public " << p);
+    assert(e.committed != nullptr);
+    mc.rc_inc(a);
+    return reinterpret_cast<const T *>(e.committed->get());
+  }
 
-    executor_id auth = view.author(a);
+  /*
+   * load_public loads public memory into a caller-provided object, with no
+   * local allocation
+   */
+  template <typename T>
+  void load_public(const GlobalPointer &p, T &dst) {
+    assert(p.is_address());
 
-    if (auth != rank_) {
+    LOGLN_OS("CTX load public " << p << " into " << &dst);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
+
+    if (e.author == rank_)
+      local_load(&dst, e.committed);
+    else
+      forward_load(&dst, p, e.author);
+  }
+
+  /*
+   * load_public_raw loads the bytes of trivially-copyable public memory into
+   * a caller-provided buffer, possibly unaligned
+   */
+  template <typename T>
+  void load_public_raw(const GlobalPointer &p, void *dst) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "raw loads require trivially-copyable types");
+    assert(p.is_address());
+
+    LOGLN_OS("CTX load public " << p << " into buffer " << dst);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      memcpy(dst, e.committed->get(), sizeof(T));
+    } else {
+      request_load(p, sizeof(T), e.author);
+      recv_payload(dst, sizeof(T), e.author);
+    }
+  }
+
+  /*
+   * load_public_range loads up to len bytes, from offset, of the contiguous
+   * payload of public memory into dst.
+   * It returns the number of loaded bytes, clipped at the end of the
+   * payload, and sets the payload size.
+   * on_chunk(offset, len) is called, in order, as each chunk of dst is
+   * loaded.
+   */
+  size_t load_public_range(const GlobalPointer &p, size_t offset, size_t len,
+                           void *dst, size_t &payload_size) {
+    return load_public_range(p, offset, len, dst, payload_size,
+                             [](size_t, size_t) {});
+  }
+
+  template <typename F>
+  size_t load_public_range(const GlobalPointer &p, size_t offset, size_t len,
+                           void *dst, size_t &payload_size, F &&on_chunk) {
+    assert(p.is_address());
+
+    LOGLN_OS("CTX load public range " << p << " [" << offset << ", +" << len
+                                      << ")");
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      const void *base = nullptr;
+      size_t size = 0;
+      e.committed->payload(base, size);
+      range_header h = serve_range(size, offset, len);
+      if (h.served) {
+        memcpy(dst, (const char *)base + offset, h.served);
+        on_chunk(0, h.served);
+      }
+      payload_size = h.payload_size;
+      return h.served;
+    }
+
+    daemon_pointer dp;
+    dp.op = daemon_pointer::RLOAD_RANGE;
+    dp.p = p;
+    dp.offset = offset;
+    dp.size = len;
+    dp.from = rank_;
+    local_links->send(dp, e.author);
+
+    range_header h;
+    local_links->raw_recv(&h, sizeof(range_header), e.author);
+    if (h.served) recv_payload(dst, h.served, e.author, on_chunk);
+    payload_size = h.payload_size;
+    return h.served;
+  }
+
+  /*
+   * store_private writes a value through to owned private memory, in place:
+   * remotely authored memory is updated by the author rather than migrated.
+   * Trivially-copyable values are received straight into committed memory,
+   * others are shipped as a frame.
+   */
+  template <typename T>
+  void store_private(const GlobalPointer &p, const T &v) {
+    assert(p.is_address());
+
+    LOGLN_OS("CTX store private " << p);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PRIVATE);
+    assert(e.owner == rank_);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      *reinterpret_cast<T *>(e.committed->get()) = v;
+      return;
+    }
+
+    daemon_pointer dp;
+    dp.op = daemon_pointer::STORE;
+    dp.p = p;
+    dp.size = sizeof(T);
+    dp.from = rank_;
+    local_links->send(dp, e.author);
+    send_kernel(v, e.author, std::is_trivially_copyable<T>{});
+  }
+
+  /*
+   * store_private_range writes len bytes from src into the contiguous payload
+   * of owned private memory, from offset.
+   * It returns the number of stored bytes, clipped at the end of the payload.
+   */
+  size_t store_private_range(const GlobalPointer &p, size_t offset,
+                             size_t len, const void *src) {
+    assert(p.is_address());
+
+    LOGLN_OS("CTX store private range " << p << " [" << offset << ", +" << len
+                                        << ")");
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PRIVATE);
+    assert(e.owner == rank_);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      const void *base = nullptr;
+      size_t size = 0;
+      e.committed->payload(base, size);
+      range_header h = serve_range(size, offset, len);
+      if (h.served)
+        memcpy((char *)const_cast<void *>(base) + offset, src, h.served);
+      return h.served;
+    }
+
+    daemon_pointer dp;
+    dp.op = daemon_pointer::STORE_RANGE;
+    dp.p = p;
+    dp.offset = offset;
+    dp.size = len;
+    dp.from = rank_;
+    local_links->send(dp, e.author);
+    if (len) local_links->raw_send(src, len, e.author);
+
+    range_header h;
+    local_links->raw_recv(&h, sizeof(range_header), e.author);
+    return h.served;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * atomics on public memory
+   *
+   ***************************************************************************
+   */
+  /*
+   * the route of atomic operations on a public address, resolved once per
+   * holder: either fabric atomics on the exposed value, or CPU atomics by
+   * the author (i.e., by its daemon, if remote).
+   * Fabric atomics are routed through the fabric also by the author, as they
+   * are not atomic with respect to CPU atomics.
+   */
+  struct atomic_route {
+    bool resolved = false, fabric = false;
+    links_impl<void>::rma_window w;
+  };
+
+  /*
+   * atomic_apply applies op to integral public memory, returning the
+   * previous value; compare is only used by AO_CSWAP
+   */
+  template <typename T>
+  T atomic_apply(const GlobalPointer &p, AtomicOp op, T operand, T compare,
+                 atomic_route &r) {
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "atomics apply to non-boolean integral types");
+    assert(p.is_address());
+
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PUBLIC);
+    if (!r.resolved) resolve_atomic<T>(p, e, r);
+
+    if (r.fabric)
+      return local_links->atomic(op, operand, compare, e.author, r.w);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      return cpu_atomic((T *)e.committed->get(), op, operand, compare);
+    }
+
+    daemon_pointer dp;
+    dp.op = daemon_pointer::ATOMIC;
+    dp.p = p;
+    dp.size = sizeof(T);
+    dp.from = rank_;
+    atomic_request req;
+    req.op = op;
+    memcpy(&req.operand, &operand, sizeof(T));
+    memcpy(&req.compare, &compare, sizeof(T));
+    local_links->send(dp, e.author);
+    local_links->raw_send(&req, sizeof(atomic_request), e.author);
+
+    T res;
+    local_links->raw_recv(&res, sizeof(T), e.author);
+    return res;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * active messages
+   *
+   ***************************************************************************
+   */
+  /*
+   * invoke runs handler H on the committed memory at p, in place by its
+   * author (i.e., by its daemon, if remote), and returns the handler result.
+   * Handlers with no result are not waited for.
+   * Mutating handlers may only apply to public memory that is never loaded,
+   * but only accessed by handlers (or by apply_local), as they are
+   * serialized with each other only.
+   */
+  template <typename H, typename... Args>
+  typename H::result_type invoke(const GlobalPointer &p,
+                                 const Args &... args) {
+    assert(p.is_address());
+
+    LOGLN_OS("CTX invoke " << H::key << " on " << p);
+    View::entry e = view.record(p.address());
+    typename H::args_type a(args...);
+
+    if (e.author == rank_) {
+      assert(e.committed != nullptr);
+      std::lock_guard<std::mutex> lg(am_mtx);
+      return H::call(e.committed->get(), a);
+    }
+
+    using void_result = std::is_void<typename H::result_type>;
+    daemon_pointer dp;
+    dp.op = void_result::value ? daemon_pointer::AM_SEND
+                               : daemon_pointer::AM_CALL;
+    dp.p = p;
+    dp.offset = H::key;
+    dp.from = rank_;
+    local_links->send(dp, e.author);
+    send_kernel(a, e.author, std::false_type{});
+    return recv_result<typename H::result_type>(e.author, void_result{});
+  }
+
+  /*
+   * apply_local runs f on locally authored memory, serialized with
+   * active-message handlers
+   */
+  template <typename T, typename F>
+  void apply_local(const GlobalPointer &p, F &&f) {
+    assert(p.is_address());
+    View::entry e = view.record(p.address());
+    assert(e.author == rank_);
+    assert(e.committed != nullptr);
+
+    std::lock_guard<std::mutex> lg(am_mtx);
+    f(*reinterpret_cast<T *>(e.committed->get()));
+  }
+
+  /*
+   * local_private returns the pointer associated to (private) global address
+   */
+  template <typename T>
+  T *local_private(const GlobalPointer &p, bool &linked) {
+    assert(p.is_address());
+    LOGLN_OS("CTX local private " << p);
+    View::entry e = view.record(p.address());
+    assert(e.access_level == AL_PRIVATE);
+
+    if (e.author != rank_) {
       /* steal memory and swap authorship */
-      withdraw<T>(p);
-      forward_reset(p, auth);
+      T *res = withdraw<T>(p);
+      forward_reset(p, e.author);
+      linked = true;
+      return res;
     }
 
-    return reinterpret_cast<T *>(view.committed(a)->get());
+    linked = e.linked;
+    return reinterpret_cast<T *>(e.committed->get());
   }
 
   /*
@@ -471,49 +964,51 @@ class Context {
   GlobalPointer publish(const GlobalPointer &p) {
     LOGLN_OS("CTX publishing p=" << p);
     assert(p.is_address());
-    assert(is_private(p));
-    assert(am_owner(p));
     uint64_t a = p.address();
-    executor_id auth = view.author(a);
+    View::entry e = view.record(a);
+    assert(e.access_level == AL_PRIVATE);
+    assert(e.owner == rank_);
+    executor_id auth = e.author;
 
     /* map to fresh global address */
-    auto res = make_global(rank_);
+    auto res = addresses.make();
     assert(res.is_address());
     uint64_t a_ = res.address();
-    view.bind_access_level(a_, AL_PUBLIC);
 
     /* steal memory */
     backend_ptr *bp_;
     if (auth == rank_) {
-      assert(view.has_child(a));
-      assert(view.has_parent(view.child(a)));
-
-      view.unbind_parent(view.child(a));
-      bp_ = view.committed(a);
+      assert(e.child != nullptr);
+      unbind_parent(e.child, e.linked);
+      bp_ = e.committed;
+      accounting.release(AL_PRIVATE, bp_->size());
     } else {
-      assert(!view.has_child(a));
+      assert(e.child == nullptr);
 
       /* allocate backend memory */
-      T *tmp = (T *)local_new<T>();
-      using bp_t = backend_typed_ptr<T, void (*)(T *)>;
-      auto tbp_ = local_new<bp_t>(tmp, DELETE<T>);
+      auto tbp_ = local_new<backend_inline_ptr<T>>();
 
       /* remote load */
-      forward_load(tbp_->typed_get(), p);
+      forward_load(tbp_->typed_get(), p, auth);
       bp_ = tbp_;
 
       /* notify remote author  */
       forward_reset(p, auth);
     }
 
-    /* clear old entry */
+    /* clear old entry, recycling the address if home */
     view.unmap(a);
+    if (auth == rank_) addresses.release(p);
 
     /* update fresh entry */
-    view.bind_committed(a_, bp_);
-    view.bind_author(a_, rank_);
-    view.bind_owner(a_, (executor_id)GlobalPointer::max_home + 1);  // dummy
-    view.bind_child(a_, nullptr);                                   // dummy
+    accounting.commit(AL_PUBLIC, bp_->size());
+    view.update(a_, [&](View::entry &r) {
+      r.committed = bp_;
+      r.access_level = AL_PUBLIC;
+      r.author = rank_;
+      r.owner = (executor_id)GlobalPointer::max_home + 1;  // dummy
+      r.child = nullptr;                                   // dummy
+    });
 
     return res;
   }
@@ -551,13 +1046,19 @@ class Context {
     return view.author(p.address());
   }
 
+  /*
+   * parenthood of private children, either linked by allocation header or
+   * (for adopted memory) tracked by the view
+   */
   template <typename T>
-  bool has_parent(T *lp) {
+  bool has_parent(T *lp, bool linked) {
+    if (linked) return wrapped_allocator::header(lp)->parent != 0;
     return view.has_parent((void *)lp);
   }
 
   template <typename T>
-  GlobalPointer parent(T *lp) {
+  GlobalPointer parent(T *lp, bool linked) {
+    if (linked) return GlobalPointer(wrapped_allocator::header(lp)->parent);
     return GlobalPointer(view.parent((void *)lp));
   }
 
@@ -576,33 +1077,59 @@ class Context {
   inline void rc_inc(const GlobalPointer &p) {
     assert(p.is_address());
     uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PUBLIC);
+    View::entry e = view.record(a);
+    assert(e.access_level == AL_PUBLIC);
 
-    if (view.author(a) == rank_)
+    if (e.author == rank_)
       mc.rc_inc(a);
     else
-      forward_inc(p);
+      forward_inc(p, e.author);
   }
 
   inline void rc_dec(const GlobalPointer &p) {
     assert(p.is_address());
     uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PUBLIC);
+    View::entry e = view.record(a);
+    assert(e.access_level == AL_PUBLIC);
 
-    if (view.author(a) == rank_) {
+    if (e.author == rank_) {
       if (mc.rc_dec(a) == 0)
         /*
          * destroy and un-bind committed memory
          */
         unmap(p);
     } else
-      forward_dec(p);
+      forward_dec(p, e.author);
+  }
+
+  /*
+   * increment a batch of reference counters, issuing at most one remote
+   * request per author
+   */
+  inline void rc_inc_batch(const GlobalPointer *ps, size_t n) {
+    std::unordered_map<executor_id, std::vector<uint64_t>> remote;
+
+    for (size_t i = 0; i < n; ++i) {
+      if (!ps[i].is_address()) continue;
+      uint64_t a = ps[i].address();
+      View::entry e = view.record(a);
+      assert(e.access_level == AL_PUBLIC);
+
+      executor_id auth = e.author;
+      if (auth == rank_)
+        mc.rc_inc(a);
+      else
+        remote[auth].push_back(a);
+    }
+
+    for (auto &r : remote) forward_inc_batch(r.second, r.first);
   }
 
   inline unsigned long long rc_get(GlobalPointer gp) {
     assert(gp.is_address());
     uint64_t a = gp.address();
-    return view.author(a) == rank_ ? local_rc_get(a) : forward_rc(gp);
+    executor_id auth = view.author(a);
+    return auth == rank_ ? local_rc_get(a) : forward_rc(gp, auth);
   }
 
   /*
@@ -648,12 +1175,18 @@ class Context {
   executor_id rank_, cardinality_;
   std::vector<std::string> hostnames;
 
-  View view;            // concurrent memory table
-  MemoryController mc;  // concurrent reference counting table
+  View view;                  // concurrent memory table
+  MemoryController mc;        // concurrent reference counting table
+  Accounting &accounting = Accounting::instance();  // live memory usage
+  AddressGenerator addresses;  // generator for addresses homed here
+  affinity_config affinity;    // cpu and numa placement
 
   std::thread *daemon;
   std::atomic<char> daemon_termination;
 
+  /* serializes active-message handlers, whether run locally or by daemon */
+  std::mutex am_mtx;
+
   /*
    ***************************************************************************
    *
@@ -667,17 +1200,69 @@ class Context {
     AccessLevel al;
   };
 
+  /*
+   * a pap message carries a batch of up to pap_batch_max pointers,
+   * only the first count entries are actually sent
+   */
+  static constexpr size_t pap_batch_max = 256;
+
+  struct pap_message {
+    executor_id from;
+    uint32_t count;
+    pap_pointer items[pap_batch_max];
+  };
+
   struct daemon_pointer {
-    enum { RLOAD, RC_INC, RC_DEC, RC_GET, PVT_RESET, DMN_END } op;
-    size_t size;  // remote-load size
+    enum {
+      RLOAD,
+      RLOAD_RANGE,
+      RNDV_DONE,
+      CONSTRUCT,
+      STORE,
+      STORE_RANGE,
+      ATOMIC,
+      ATOMIC_WINDOW,
+      AM_CALL,
+      AM_SEND,
+      RC_INC,
+      RC_INC_BATCH,
+      RC_DEC,
+      RC_GET,
+      PVT_RESET,
+      DMN_END
+    } op;
+    size_t size;    // remote-load size, batch length, rendezvous id, ...
+    size_t offset;  // remote-load/store offset, constructor or handler key
     executor_id from;
     GlobalPointer p;
   };
 
+  /*
+   * rendezvous header, preceding payloads above the links threshold
+   */
+  struct rndv_header {
+    uint64_t id;   // to be released by RNDV_DONE
+    bool exposed;  // otherwise the payload follows eagerly
+    Links<daemon_pointer>::rma_window w;
+  };
+
+  /*
+   * daemon-executed atomic operation, operands in their first sizeof(T) bytes
+   */
+  struct atomic_request {
+    AtomicOp op;
+    uint64_t operand = 0, compare = 0;
+  };
+
   /*
    * links for pushing and pulling pointers (svc A)
    */
-  Links<pap_pointer> *pap_links;
+  Links<pap_message> *pap_links;
+
+  /*
+   * pulled but not yet consumed pointers, one queue per source executor
+   */
+  std::vector<std::deque<pap_pointer>> pap_pending;
 
   /*
    * links for:
@@ -708,9 +1293,19 @@ class Context {
    */
   class Daemon {
    public:
-    Daemon(Context &ctx) : ctx(ctx), cnt(ctx.cardinality_ - 1) {}
+    Daemon(Context &ctx)
+        : ctx(ctx),
+          cnt(ctx.cardinality_ - 1),
+          staging(ctx.local_allocator.std_allocator_for<char>()),
+          replies(ctx.local_allocator.std_allocator_for<char>()) {}
+
+    ~Daemon() { assert(exposed.empty()); }
 
     void operator()() {
+      if (ctx.affinity.pin_daemon &&
+          !pin_this_thread(ctx.affinity.daemon_cpus))
+        LOGLN("DMN could not pin daemon thread");
+
       if (cnt) {
         ctx.remote_links->nb_recv(p);
 
@@ -735,6 +1330,63 @@ class Context {
     executor_id cnt;  // terminated partitions
     daemon_pointer p;
 
+    /* frame buffers for framed marshalling, drawn from registered memory */
+    frame_buffer staging;
+    frame_buffer replies;  // handler results, while arguments are staged
+
+    /* payloads exposed by rendezvous, until released by the reader */
+    struct exposure {
+      void *handle;        // on-demand registration, if any
+      GlobalPointer pin;   // public memory pinned while exposed, if any
+      frame_buffer frame;  // frame retained while exposed, if any
+    };
+    std::unordered_map<uint64_t, exposure> exposed;
+    uint64_t next_rndv = 0;
+
+    /*
+     * send a load response payload, by rendezvous above the links threshold:
+     * the payload is exposed and either the public memory it belongs to is
+     * pinned or the frame holding it is retained
+     */
+    void send_payload(const void *base, size_t size, executor_id to,
+                      const GlobalPointer &pin, frame_buffer *frame) {
+      if (Links<daemon_pointer>::rendezvous(size)) {
+        rndv_header h;
+        void *handle = nullptr;
+        h.id = next_rndv++;
+        h.exposed = Links<daemon_pointer>::expose(base, size, h.w, handle);
+        ctx.remote_links->raw_send(&h, sizeof(rndv_header), to);
+        if (h.exposed) {
+          LOGLN("DMN expose size=%zu to=%lu id=%llu", size, to, h.id);
+          if (pin.is_address()) ctx.mc.rc_inc(pin.address());
+          frame_buffer retained(ctx.local_allocator.std_allocator_for<char>());
+          if (frame) retained.swap(*frame);
+          exposed.emplace(h.id, exposure{handle, pin, std::move(retained)});
+          return;
+        }
+        LOGLN("DMN could not expose size=%zu, sending eagerly", size);
+      }
+      ctx.remote_links->raw_send(base, size, to);
+    }
+
+    /*
+     * private memory is only loaded by its owner, which releases the
+     * exposure before resetting it, whereas public memory may be released
+     * by any holder meanwhile
+     */
+    GlobalPointer public_pin(const View::entry &e) const {
+      return e.access_level == AL_PUBLIC ? p.p : GlobalPointer();
+    }
+
+    /* apply an atomic request on the first sizeof(U) bytes of operands */
+    template <typename U>
+    static U cpu_atomic(void *v, const atomic_request &req) {
+      U operand, compare;
+      memcpy(&operand, &req.operand, sizeof(U));
+      memcpy(&compare, &req.compare, sizeof(U));
+      return Context::cpu_atomic((U *)v, req.op, operand, compare);
+    }
+
     void poll_iteration() {
       if (ctx.remote_links->nb_poll()) {
         /* handle the incoming request */
@@ -745,6 +1397,16 @@ class Context {
             assert(ctx.view.author(a) == ctx.rank_);
             ctx.mc.rc_inc(a);
             break;
+          case daemon_pointer::RC_INC_BATCH: {
+            LOGLN("DMN recv +1 batch size=%zu from %lu", p.size, p.from);
+            std::vector<uint64_t> as(p.size);
+            ctx.remote_links->raw_recv(as.data(), p.size * sizeof(uint64_t),
+                                       p.from);
+            for (auto a_ : as) {
+              assert(ctx.view.author(a_) == ctx.rank_);
+              ctx.mc.rc_inc(a_);
+            }
+          } break;
           case daemon_pointer::RC_DEC:
             LOGLN("DMN recv -1 %llu from %lu", a, p.from);
             assert(ctx.view.author(a) == ctx.rank());
@@ -752,24 +1414,159 @@ class Context {
             break;
           case daemon_pointer::RC_GET: {
             LOGLN("DMN recv RC_GET %llu from %lu", a, p.from);
-            assert(ctx.view.author(a) == ctx.rank_);
-            assert(ctx.view.committed(a) != nullptr);
+            assert(ctx.am_author_of_committed(a));
             unsigned long long rc = ctx.local_rc_get(a);
             ctx.remote_links->raw_send(&rc, sizeof(unsigned long long), p.from);
           } break;
           case daemon_pointer::PVT_RESET:
             LOGLN("DMN recv PVT -1 %llu from %lu", a, p.from);
-            assert(ctx.view.author(a) == ctx.rank_);
-            assert(ctx.view.committed(a) != nullptr);
+            assert(ctx.am_author_of_committed(a));
             ctx.unmap(p.p);
             break;
-          case daemon_pointer::RLOAD:
+          case daemon_pointer::RLOAD: {
             LOGLN("DMN recv RLOAD %llu from %lu", a, p.from);
-            assert(ctx.view.author(a) == ctx.rank_);
-            assert(ctx.view.committed(a) != nullptr);
-            for (auto &me : ctx.view.committed(a)->marshall())
-              ctx.remote_links->raw_send(me.base, me.size, p.from);
-            break;
+            View::entry e = ctx.view.record(a);
+            assert(e.author == ctx.rank_);
+            assert(e.committed != nullptr);
+            if (e.committed->framed()) {
+              frame_header h = e.committed->pack(staging);
+              ctx.remote_links->raw_send(&h, sizeof(frame_header), p.from);
+              if (h.size)
+                send_payload(staging.data(), h.size, p.from, GlobalPointer(),
+                             &staging);
+            } else if (e.committed->mode() == marshal_mode::copy)
+              send_payload(e.committed->get(), e.committed->size(), p.from,
+                           public_pin(e), nullptr);
+            else
+              for (auto &me : e.committed->marshall())
+                ctx.remote_links->raw_send(me.base, me.size, p.from);
+          } break;
+          case daemon_pointer::RLOAD_RANGE: {
+            LOGLN("DMN recv RLOAD_RANGE %llu [%zu, +%zu) from %lu", a,
+                  p.offset, p.size, p.from);
+            View::entry e = ctx.view.record(a);
+            assert(e.author == ctx.rank_);
+            assert(e.committed != nullptr);
+            const void *base = nullptr;
+            size_t len = 0;
+            e.committed->payload(base, len);
+            range_header h = serve_range(len, p.offset, p.size);
+            ctx.remote_links->raw_send(&h, sizeof(range_header), p.from);
+            if (h.served)
+              send_payload((const char *)base + p.offset, h.served, p.from,
+                           public_pin(e), nullptr);
+          } break;
+          case daemon_pointer::RNDV_DONE: {
+            LOGLN("DMN recv RNDV_DONE id=%zu from %lu", p.size, p.from);
+            auto it = exposed.find(p.size);
+            assert(it != exposed.end());
+            Links<daemon_pointer>::unexpose(it->second.handle);
+            const GlobalPointer &pin = it->second.pin;
+            if (pin.is_address() && ctx.mc.rc_dec(pin.address()) == 0)
+              ctx.unmap(pin);
+            exposed.erase(it);
+          } break;
+          case daemon_pointer::STORE: {
+            LOGLN("DMN recv STORE %llu from %lu", a, p.from);
+            assert(ctx.am_author_of_committed(a));
+            backend_ptr *bp = ctx.view.record(a).committed;
+            assert(bp->size() == p.size);
+            if (bp->mode() == marshal_mode::copy)
+              ctx.remote_links->raw_recv(bp->get(), p.size, p.from);
+            else {
+              frame_header h;
+              ctx.remote_links->raw_recv(&h, sizeof(frame_header), p.from);
+              staging.resize(h.size);
+              if (h.size)
+                ctx.remote_links->raw_recv(staging.data(), h.size, p.from);
+              bp->unpack(staging.data(), h);
+            }
+          } break;
+          case daemon_pointer::STORE_RANGE: {
+            LOGLN("DMN recv STORE_RANGE %llu [%zu, +%zu) from %lu", a,
+                  p.offset, p.size, p.from);
+            assert(ctx.am_author_of_committed(a));
+            const void *base = nullptr;
+            size_t len = 0;
+            ctx.view.record(a).committed->payload(base, len);
+            range_header h = serve_range(len, p.offset, p.size);
+            char *dst = (char *)const_cast<void *>(base) + p.offset;
+            if (h.served == p.size) {
+              /* straight into the payload */
+              if (p.size) ctx.remote_links->raw_recv(dst, p.size, p.from);
+            } else {
+              staging.resize(p.size);
+              if (p.size)
+                ctx.remote_links->raw_recv(staging.data(), p.size, p.from);
+              if (h.served) memcpy(dst, staging.data(), h.served);
+            }
+            ctx.remote_links->raw_send(&h, sizeof(range_header), p.from);
+          } break;
+          case daemon_pointer::ATOMIC: {
+            LOGLN("DMN recv ATOMIC %llu from %lu", a, p.from);
+            assert(ctx.am_author_of_committed(a));
+            atomic_request req;
+            ctx.remote_links->raw_recv(&req, sizeof(atomic_request), p.from);
+            void *v = ctx.view.record(a).committed->get();
+            uint64_t res = 0;
+            switch (p.size) {
+              case 1:
+                res = cpu_atomic<uint8_t>(v, req);
+                break;
+              case 2:
+                res = cpu_atomic<uint16_t>(v, req);
+                break;
+              case 4:
+                res = cpu_atomic<uint32_t>(v, req);
+                break;
+              default:
+                assert(p.size == 8);
+                res = cpu_atomic<uint64_t>(v, req);
+                break;
+            }
+            ctx.remote_links->raw_send(&res, p.size, p.from);
+          } break;
+          case daemon_pointer::ATOMIC_WINDOW: {
+            LOGLN("DMN recv ATOMIC_WINDOW %llu from %lu", a, p.from);
+            assert(ctx.am_author_of_committed(a));
+            rndv_header h = ctx.atomic_window(ctx.view.record(a).committed);
+            ctx.remote_links->raw_send(&h, sizeof(rndv_header), p.from);
+          } break;
+          case daemon_pointer::AM_CALL:
+          case daemon_pointer::AM_SEND: {
+            LOGLN("DMN recv AM key=%zu %llu from %lu", p.offset, a, p.from);
+            assert(ctx.am_author_of_committed(a));
+            frame_header h;
+            ctx.remote_links->raw_recv(&h, sizeof(frame_header), p.from);
+            staging.resize(h.size);
+            if (h.size)
+              ctx.remote_links->raw_recv(staging.data(), h.size, p.from);
+            am_fn fn = am_registry::find(p.offset);
+            assert(fn != nullptr);
+            void *obj = ctx.view.record(a).committed->get();
+            {
+              std::lock_guard<std::mutex> lg(ctx.am_mtx);
+              h = fn(obj, staging.data(), h, replies);
+            }
+            if (p.op == daemon_pointer::AM_CALL) {
+              ctx.remote_links->raw_send(&h, sizeof(frame_header), p.from);
+              if (h.size)
+                send_payload(replies.data(), h.size, p.from, GlobalPointer(),
+                             &replies);
+            }
+          } break;
+          case daemon_pointer::CONSTRUCT: {
+            LOGLN("DMN recv CONSTRUCT key=%zu from %lu", p.offset, p.from);
+            std::vector<char> args(p.size);
+            ctx.remote_links->raw_recv(args.data(), p.size, p.from);
+            GlobalPointer res;
+            ctor_t ctor = ctor_registry::find(p.offset);
+            if (ctor)
+              res = ctor(ctx, p.from, args.data());
+            else
+              LOGLN("DMN unknown constructor key=%zu", p.offset);
+            ctx.remote_links->raw_send(&res, sizeof(GlobalPointer), p.from);
+          } break;
           case daemon_pointer::DMN_END:
             LOGLN("DMN recv RC_END from %lu", p.from);
             --cnt;
@@ -785,48 +1582,233 @@ class Context {
     }
   };
 
-  template <AccessLevel al, class T, typename Deleter>
-  GlobalPointer mmap_global(T *lp, Deleter d) {
-    auto res = make_global(rank_);
-    uint64_t a = res.address();
+  /*
+   ***************************************************************************
+   *
+   * atomics support
+   *
+   ***************************************************************************
+   */
+  template <typename T>
+  static T cpu_atomic(T *v, AtomicOp op, T operand, T compare) {
+    switch (op) {
+      case AO_LOAD:
+        return __atomic_load_n(v, __ATOMIC_SEQ_CST);
+      case AO_FETCH_ADD:
+        return __atomic_fetch_add(v, operand, __ATOMIC_SEQ_CST);
+      case AO_SWAP:
+        return __atomic_exchange_n(v, operand, __ATOMIC_SEQ_CST);
+      case AO_CSWAP:
+        __atomic_compare_exchange_n(v, &compare, operand, false,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+        return compare;
+    }
+    assert(false);
+    return T();
+  }
+
+  /*
+   * expose a committed value for fabric atomics, provided it lies in
+   * registered memory, so that it stays exposed while referenced
+   */
+  rndv_header atomic_window(backend_ptr *bp) {
+    rndv_header h;
+    void *handle = nullptr;
+    h.id = 0;
+    h.exposed =
+        Links<daemon_pointer>::expose(bp->get(), bp->size(), h.w, handle);
+    if (handle) {
+      Links<daemon_pointer>::unexpose(handle);
+      h.exposed = false;
+    }
+    return h;
+  }
+
+  template <typename T>
+  void resolve_atomic(const GlobalPointer &p, const View::entry &e,
+                      atomic_route &r) {
+    r.resolved = true;
+    if (!local_links->atomic_valid<T>()) return;
+
+    rndv_header h;
+    if (e.author == rank_)
+      h = atomic_window(e.committed);
+    else {
+      daemon_pointer dp;
+      dp.op = daemon_pointer::ATOMIC_WINDOW;
+      dp.p = p;
+      dp.from = rank_;
+      local_links->send(dp, e.author);
+      local_links->raw_recv(&h, sizeof(rndv_header), e.author);
+    }
+    r.fabric = h.exposed;
+    r.w = h.w;
+    LOGLN_OS("CTX atomics on " << p << " by " << (r.fabric ? "fabric" : "CPU"));
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * remote allocation
+   *
+   ***************************************************************************
+   */
+  using ctor_t = GlobalPointer (*)(Context &, executor_id, const void *);
+  using ctor_registry = registry<ctor_t>;
+
+  /*
+   * constructor of T objects from Params, run by the daemon of the author
+   * on behalf of the requester
+   */
+  template <AccessLevel al, class T, typename... Params>
+  struct remote_new {
+    using pack_t = arg_pack<Params...>;
+
+    static GlobalPointer construct(Context &ctx, executor_id requester,
+                                   const void *args) {
+      typename std::aligned_storage<sizeof(pack_t), alignof(pack_t)>::type
+          pack;
+      memcpy(&pack, args, sizeof(pack_t));
+      return apply_pack(new_for<al, T>{ctx, requester},
+                        *reinterpret_cast<const pack_t *>(&pack));
+    }
+
+    static const uint64_t key;  // registered at static initialization
+  };
+
+  template <AccessLevel al, class T>
+  struct new_for {
+    Context &ctx;
+    executor_id requester;
+
+    template <typename... Params>
+    GlobalPointer operator()(const Params &... p) const {
+      return ctx.mmap_new_for<al, T>(requester, p...);
+    }
+  };
+
+  template <AccessLevel al, class T, typename... Params>
+  GlobalPointer construct_on(executor_id e, Params... p) {
+    static_assert(all_shippable<Params...>::value,
+                  "remote allocation requires shippable arguments");
+    assert(e != rank_);
+    LOGLN("CTX construct on %lu", e);
+
+    auto args = make_arg_pack(p...);
+    daemon_pointer dp;
+    dp.op = daemon_pointer::CONSTRUCT;
+    dp.offset = remote_new<al, T, Params...>::key;
+    dp.size = sizeof(args);
+    dp.from = rank_;
+    local_links->send(dp, e);
+    local_links->raw_send(&args, sizeof(args), e);
+
+    pap_pointer buf;
+    buf.al = al;
+    buf.author = e;
+    local_links->raw_recv(&buf.p, sizeof(GlobalPointer), e);
+    if (!buf.p.is_address()) return buf.p;
+    return al == AL_PUBLIC ? pulled_public(buf) : pulled_private(buf);
+  }
+
+  template <AccessLevel al, class T, typename... Params>
+  GlobalPointer mmap_new_for(executor_id requester, const Params &... p) {
+    if (al == AL_PUBLIC) {
+      GlobalPointer res = mmap_public_new<T>(p...);
+      if (res.is_address()) rc_init(res);  // the requester reference
+      return res;
+    }
 
-    LOGLN("CTX mmap global=%llu -> local=%p", a, lp);
+    /* as if pushed to the requester */
+    GlobalPointer res = mmap_private_new<T>(p...);
+    if (res.is_address())
+      view.update(res.address(), [&](View::entry &r) { r.owner = requester; });
+    return res;
+  }
 
+  template <AccessLevel al, class T, typename Deleter>
+  GlobalPointer mmap_global(T *lp, Deleter d, executor_id owner, void *child) {
     /* implicit commit */
-    assert(view.committed(a) == nullptr);
     using bp_t = backend_typed_ptr<T, Deleter>;
     bp_t *bp = local_new<bp_t>(lp, d);
-    view.bind_committed(a, bp);
+
+    return mmap_backend<al>(bp, owner, child,
+                            child != nullptr && allocated_locally(d));
+  }
+
+  /*
+   * map a fresh global address to committed memory
+   */
+  template <AccessLevel al>
+  GlobalPointer mmap_backend(backend_ptr *bp, executor_id owner, void *child,
+                             bool linked) {
+    auto res = addresses.make();
+    uint64_t a = res.address();
+
+    LOGLN("CTX mmap global=%llu -> local=%p", a, bp->get());
+    accounting.commit(al, bp->size());
 
     /* update view information */
-    view.bind_access_level(a, al);
-    view.bind_author(a, rank_);
+    view.update(a, [&](View::entry &e) {
+      assert(e.committed == nullptr);
+      e.committed = bp;
+      e.access_level = al;
+      e.author = rank_;
+      e.owner = owner;
+      e.child = child;
+      e.linked = linked;
+    });
 
     return res;
   }
 
-  void munmap(const GlobalPointer &p) {
-    uint64_t a = p.address();
+  /*
+   * children allocated by local_new (i.e., deleted by DELETE) carry their
+   * parent address in the allocation header, others are tracked by the view
+   */
+  template <typename T>
+  static bool allocated_locally(void (*d)(T *)) {
+    return d == DELETE<T>;
+  }
 
-    backend_ptr *cm = view.committed(a);
-    assert(cm != nullptr);
+  template <typename Deleter>
+  static bool allocated_locally(const Deleter &) {
+    return false;
+  }
 
-    /* clean up view */
-    view.unmap(a);
+  void bind_parent(void *c, uint64_t a, bool linked) {
+    if (linked)
+      wrapped_allocator::header(c)->parent = a;
+    else
+      view.bind_parent(c, a);
+  }
 
-    /* finally release committed memory */
-    local_delete(cm);
+  void unbind_parent(void *c, bool linked) {
+    assert(has_parent(c, linked));
+    if (linked)
+      wrapped_allocator::header(c)->parent = 0;
+    else
+      view.unbind_parent(c);
+  }
+
+  /*
+   * check the executor is author of a and holds its committed copy
+   */
+  bool am_author_of_committed(uint64_t a) {
+    View::entry e;
+    return view.find(a, e) && e.author == rank_ && e.committed != nullptr;
   }
 
   GlobalPointer pulled_public(const pap_pointer &buf) {
     if (buf.p.is_address()) {
       LOGLN_OS("CTX pulled public=" << buf.p);
 
-      uint64_t a = buf.p.address();
-      view.bind_access_level(a, buf.al);
-      view.bind_owner(a, (executor_id)GlobalPointer::max_home + 1);
-      view.bind_author(a, buf.author);
-      view.bind_committed(a, nullptr);
+      view.update(buf.p.address(), [&](View::entry &e) {
+        e.access_level = buf.al;
+        e.owner = (executor_id)GlobalPointer::max_home + 1;
+        e.author = buf.author;
+        e.committed = nullptr;
+      });
     } else
       LOGLN_OS("CTX pulled reserved=" << buf.p);
 
@@ -838,25 +1820,98 @@ class Context {
       LOGLN_OS("CTX pulled private=" << buf.p);
 
       uint64_t a = buf.p.address();
-      if (!view.mapped(a) || buf.author != rank_) {
-        view.bind_access_level(a, AL_PRIVATE);
-        view.bind_author(a, buf.author);
-        view.bind_committed(a, nullptr);
-      }
+      bool fresh = !view.mapped(a) || buf.author != rank_;
+      view.update(a, [&](View::entry &e) {
+        if (fresh) {
+          e.access_level = AL_PRIVATE;
+          e.author = buf.author;
+          e.committed = nullptr;
+        }
 
-      /* take ownership */
-      view.bind_owner(a, rank_);
+        /* take ownership */
+        e.owner = rank_;
+      });
     } else
       LOGLN_OS("CTX pulled reserved=" << buf.p);
 
     return buf.p;
   }
 
+  /*
+   * send pointers to e, packing up to pap_batch_max of them per message
+   */
+  void send_pap(const pap_pointer *bufs, size_t n, const executor_id e) {
+    pap_message msg;
+    msg.from = rank_;
+
+    while (n) {
+      msg.count = (uint32_t)(n < pap_batch_max ? n : pap_batch_max);
+      std::copy(bufs, bufs + msg.count, msg.items);
+      pap_links->raw_send(&msg, pap_message_size(msg.count), e);
+      bufs += msg.count;
+      n -= msg.count;
+    }
+  }
+
+  static constexpr size_t pap_message_size(size_t count) {
+    return sizeof(pap_message) - (pap_batch_max - count) * sizeof(pap_pointer);
+  }
+
+  /*
+   * blocking receive a pap message and enqueue the carried pointers
+   */
+  void pap_fill(const executor_id e) {
+    pap_message msg;
+    pap_links->recv(msg, e);
+    assert(msg.from == e);
+    pap_enqueue(msg);
+  }
+
+  void pap_fill() {
+    pap_message msg;
+    pap_links->recv(msg);
+    pap_enqueue(msg);
+  }
+
+  void pap_enqueue(const pap_message &msg) {
+    assert(msg.from < cardinality_);
+    assert(msg.count > 0 && msg.count <= pap_batch_max);
+    LOGLN("CTX pulled pap message size=%lu from=%lu", msg.count, msg.from);
+    auto &q = pap_pending[msg.from];
+    q.insert(q.end(), msg.items, msg.items + msg.count);
+  }
+
+  /*
+   * pop the next pointer pulled from e
+   */
+  pap_pointer pap_pop(const executor_id e) {
+    if (pap_pending[e].empty()) pap_fill(e);
+    pap_pointer res = pap_pending[e].front();
+    pap_pending[e].pop_front();
+    return res;
+  }
+
+  /*
+   * pop the next pointer pulled from any executor
+   */
+  pap_pointer pap_pop() {
+    for (auto &q : pap_pending) {
+      if (!q.empty()) {
+        pap_pointer res = q.front();
+        q.pop_front();
+        return res;
+      }
+    }
+
+    pap_fill();
+    return pap_pop();
+  }
+
   template <typename T>
-  inline void local_load(T *lp, uint64_t a) {
-    LOGLN("CTX load %p size=%zu %llu", lp, sizeof(T), a);
-    assert(view.committed(a) != nullptr);
-    *lp = *reinterpret_cast<T *>(view.committed(a)->get());
+  inline void local_load(T *lp, backend_ptr *committed) {
+    LOGLN("CTX load %p size=%zu from %p", lp, sizeof(T), committed);
+    assert(committed != nullptr);
+    *lp = *reinterpret_cast<T *>(committed->get());
   }
 
   inline unsigned long long local_rc_get(uint64_t a) { return mc.rc_get(a); }
@@ -873,42 +1928,123 @@ class Context {
     assert(p.is_address());
     LOGLN_OS("CTX withdraw=" << p);
     uint64_t a = p.address();
-    assert(view.access_level(a) == AL_PRIVATE);
-    assert(!am_author(p));
-    assert(am_owner(p));
+    View::entry e = view.record(a);
+    assert(e.access_level == AL_PRIVATE);
+    assert(e.author != rank_);
+    assert(e.owner == rank_);
+    assert(e.committed == nullptr);
 
     /* allocate backend memory */
-    assert(view.committed(a) == nullptr);
-    T *tmp = (T *)local_new<T>();
-    using bp_t = backend_typed_ptr<T, void (*)(T *)>;
-    bp_t *bp = local_new<bp_t>(tmp, DELETE<T>);
-
-    /* bind parenthood */
-    T *child = bp->typed_get();
-    view.bind_parent(child, a);
-    view.bind_child(a, child);
+    auto bp = local_new<backend_inline_ptr<T>>();
+    accounting.commit(AL_PRIVATE, bp->size());
 
     /* issue remote load */
-    forward_load(child, p);
+    T *child = bp->typed_get();
+    forward_load(child, p, e.author);
 
-    /* take ownership */
-    view.bind_committed(a, bp);
-    view.bind_author(a, rank_);
+    /*
+     * take authorship under a fresh address homed here, so that the old home
+     * can recycle the previous one once reset
+     */
+    auto res = addresses.make();
+    assert(res.is_address());
+    uint64_t a_ = res.address();
+    view.update(a_, [&](View::entry &r) {
+      r.committed = bp;
+      r.child = child;
+      r.owner = rank_;
+      r.author = rank_;
+      r.access_level = AL_PRIVATE;
+      r.linked = true;
+    });
+    bind_parent(child, a_, true);
+    view.unmap(a);
 
-    return bp->typed_get();
+    return child;
   }
 
   template <typename T>
   void recv_kernel(T *lp, executor_id to, std::true_type) {
-    local_links->raw_recv(lp, sizeof(T), to);
+    recv_payload(lp, sizeof(T), to);
   }
 
   template <typename T>
   void recv_kernel(T *lp, executor_id to, std::false_type) {
+    recv_ingest(lp, to, framed_object<T>{});
+  }
+
+  /* one receive per marshalled entry */
+  template <typename T>
+  void recv_ingest(T *lp, executor_id to, std::false_type) {
     lp->ingest(
         [&](void *dst, size_t size) { local_links->raw_recv(dst, size, to); });
   }
 
+  /* one receive for the whole frame, then ingest from memory */
+  template <typename T>
+  void recv_ingest(T *lp, executor_id to, std::true_type) {
+    frame_header h;
+    local_links->raw_recv(&h, sizeof(frame_header), to);
+    LOGLN("CTX recv frame entries=%llu size=%llu",
+          (unsigned long long)h.n_entries, (unsigned long long)h.size);
+    char *frame = (char *)local_allocator.malloc(h.size);
+    if (h.size) recv_payload(frame, h.size, to);
+    unpack_object(*lp, frame, h);
+    local_allocator.free(frame);
+  }
+
+  /*
+   * receive a load response payload, either eagerly or by rendezvous (i.e.,
+   * reading the payload exposed by the author, then releasing it)
+   */
+  void recv_payload(void *dst, size_t size, executor_id from) {
+    recv_payload(dst, size, from, [](size_t, size_t) {});
+  }
+
+  template <typename F>
+  void recv_payload(void *dst, size_t size, executor_id from, F &&on_chunk) {
+    if (Links<daemon_pointer>::rendezvous(size)) {
+      rndv_header h;
+      local_links->raw_recv(&h, sizeof(rndv_header), from);
+      if (h.exposed) {
+        LOGLN("CTX rendezvous read size=%zu from=%lu", size, from);
+        local_links->rma_read(dst, size, from, h.w, on_chunk);
+        daemon_pointer dp;
+        dp.op = daemon_pointer::RNDV_DONE;
+        dp.size = h.id;
+        dp.from = rank_;
+        local_links->send(dp, from);
+        return;
+      }
+    }
+    local_links->stream_recv(dst, size, from, on_chunk);
+  }
+
+  /* receive the result of a handler, as a frame */
+  template <typename R>
+  R recv_result(executor_id to, std::false_type) {
+    R res;
+    recv_ingest(&res, to, std::true_type{});
+    return res;
+  }
+
+  template <typename R>
+  R recv_result(executor_id, std::true_type) {}
+
+  template <typename T>
+  void send_kernel(const T &v, executor_id to, std::true_type) {
+    local_links->raw_send(&v, sizeof(T), to);
+  }
+
+  /* one send for the whole frame */
+  template <typename T>
+  void send_kernel(const T &v, executor_id to, std::false_type) {
+    frame_buffer frame(local_allocator.std_allocator_for<char>());
+    frame_header h = pack_object(const_cast<T &>(v), frame);
+    local_links->raw_send(&h, sizeof(frame_header), to);
+    if (h.size) local_links->raw_send(frame.data(), h.size, to);
+  }
+
   unsigned long long recv_rc(executor_id to) {
     unsigned long long res;
     local_links->raw_recv(&res, sizeof(unsigned long long), to);
@@ -916,28 +2052,28 @@ class Context {
   }
 
   template <typename T>
-  void forward_load(T *lp, const GlobalPointer &p) {
+  void forward_load(T *lp, const GlobalPointer &p, executor_id to) {
     assert(p.is_address());
-    uint64_t a = p.address();
-    executor_id to = view.author(a);
-    LOGLN("CTX fwd LOAD size=%zu %llu dest=%lu", sizeof(T), a, to);
+    assert(to == view.author(p.address()));
+    LOGLN("CTX fwd LOAD size=%zu %llu dest=%lu", sizeof(T), p.address(), to);
+
+    request_load(p, sizeof(T), to);
+    recv_kernel(lp, to, std::is_trivially_copyable<T>{});
+  }
 
-    /* send remote-load request */
+  /* send remote-load request */
+  void request_load(const GlobalPointer &p, size_t size, executor_id to) {
     daemon_pointer dp;
     dp.op = daemon_pointer::RLOAD;
     dp.p = p;
-    dp.size = sizeof(T);
+    dp.size = size;
     dp.from = rank_;
     local_links->send(dp, to);
-
-    recv_kernel(lp, to, std::is_trivially_copyable<T>{});
   }
 
-  unsigned long long forward_rc(const GlobalPointer &p) {
+  unsigned long long forward_rc(const GlobalPointer &p, executor_id to) {
     assert(p.is_address());
-    uint64_t a = p.address();
-    executor_id to = view.author(a);
-    LOGLN("CTX fwd RC %llu dest=%lu", a, to);
+    LOGLN("CTX fwd RC %llu dest=%lu", p.address(), to);
 
     /* send remote-rc request */
     daemon_pointer dp;
@@ -949,11 +2085,9 @@ class Context {
     return recv_rc(to);
   }
 
-  inline void forward_inc(const GlobalPointer &p) {
+  inline void forward_inc(const GlobalPointer &p, executor_id dest) {
     assert(p.is_address());
-    uint64_t a = p.address();
-    executor_id dest = view.author(a);
-    LOGLN("CTX fwd +1 %llu dest=%lu", a, dest);
+    LOGLN("CTX fwd +1 %llu dest=%lu", p.address(), dest);
     daemon_pointer dp;
     dp.op = daemon_pointer::RC_INC;
     dp.from = rank_;
@@ -961,11 +2095,20 @@ class Context {
     local_links->send(dp, dest);
   }
 
-  inline void forward_dec(const GlobalPointer &p) {
+  inline void forward_inc_batch(const std::vector<uint64_t> &as,
+                                const executor_id dest) {
+    LOGLN("CTX fwd +1 batch size=%zu dest=%lu", as.size(), dest);
+    daemon_pointer dp;
+    dp.op = daemon_pointer::RC_INC_BATCH;
+    dp.size = as.size();
+    dp.from = rank_;
+    local_links->send(dp, dest);
+    local_links->raw_send(as.data(), as.size() * sizeof(uint64_t), dest);
+  }
+
+  inline void forward_dec(const GlobalPointer &p, executor_id dest) {
     assert(p.is_address());
-    uint64_t a = p.address();
-    executor_id dest = view.author(a);
-    LOGLN("CTX fwd -1 %llu dest=%lu", a, dest);
+    LOGLN("CTX fwd -1 %llu dest=%lu", p.address(), dest);
     daemon_pointer dp;
     dp.op = daemon_pointer::RC_DEC;
     dp.from = rank_;
@@ -974,6 +2117,12 @@ class Context {
   }
 };
 
+template <AccessLevel al, class T, typename... Params>
+const uint64_t Context::remote_new<al, T, Params...>::key =
+    Context::ctor_registry::add(
+        signature_key<Context::remote_new<al, T, Params...>>(),
+        &Context::remote_new<al, T, Params...>::construct);
+
 #if __cplusplus >= 201703L
 class Context_ {
  public:
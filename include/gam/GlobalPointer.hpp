@@ -28,8 +28,11 @@
 #ifndef INCLUDE_GAM_GLOBALPOINTER_HPP_
 #define INCLUDE_GAM_GLOBALPOINTER_HPP_
 
+#include <cassert>
 #include <cstdint>
+#include <deque>
 #include <limits>
+#include <mutex>
 
 #include "gam/defs.hpp"
 #include "gam/Logger.hpp"
@@ -51,25 +54,37 @@ namespace gam {
  *
  * 64-bit descriptor is composed by:
  * - 1-bit  reserved (0 = address, 1 = reserved)
- * - 31-bit home partition
+ * - 15-bit home partition
+ * - 16-bit generation
  * - 32-bit offset
+ *
+ * Offsets are recycled by the home partition once an address is released.
+ * The generation distinguishes successive addresses sharing the same offset,
+ * so that stale pointers do not alias fresh ones: offsets are retired rather
+ * than recycled past the last generation.
  */
 class GlobalPointer {
  public:
   static constexpr uint64_t first_reserved = (uint64_t)1 << 63;
   static constexpr uint64_t last_reserved =  //
       std::numeric_limits<uint64_t>::max();
-  static constexpr uint64_t max_home = ((uint64_t)1 << 31) - 1;
+  static constexpr uint64_t max_home = ((uint64_t)1 << 15) - 1;
+  static constexpr uint64_t max_generation = ((uint64_t)1 << 16) - 1;
+  static constexpr uint64_t max_offset = ((uint64_t)1 << 32) - 1;
 
   GlobalPointer() {}
 
   explicit GlobalPointer(uint64_t descriptor) : descriptor_(descriptor) {}
 
-  GlobalPointer(executor_id home, uint64_t lsb)
-      : GlobalPointer(lsb | ((uint64_t)home << 32)) {
+  GlobalPointer(executor_id home, uint64_t offset)
+      : GlobalPointer(home, 0, offset) {}
+
+  GlobalPointer(executor_id home, uint64_t generation, uint64_t offset)
+      : GlobalPointer(offset | (generation << 32) | ((uint64_t)home << 48)) {
     assert(is_address());
-    assert((this->lsb() | ((uint64_t)home << 32)) == this->address());
     assert(home == this->home());
+    assert(generation == this->generation());
+    assert(offset == this->offset());
   }
 
   bool operator==(const GlobalPointer& gp) {
@@ -95,6 +110,16 @@ class GlobalPointer {
    */
   inline uint64_t address() const { return descriptor_; }
 
+  inline executor_id home() const {
+    return (executor_id)((descriptor_ >> 48) & max_home);
+  }
+
+  inline uint64_t generation() const {
+    return (descriptor_ >> 32) & max_generation;
+  }
+
+  inline uint64_t offset() const { return descriptor_ & max_offset; }
+
   /*
    ***************************************************************************
    *
@@ -109,7 +134,8 @@ class GlobalPointer {
    */
   friend std::ostream& operator<<(std::ostream& out, const GlobalPointer& f) {
     if (f.is_address())
-      out << "{addr=" << f.address() << " home=" << f.home() << "}";
+      out << "{addr=" << f.address() << " home=" << f.home()
+          << " gen=" << f.generation() << "}";
     else
       out << "{token=" << f.address() << "}";
     return out;
@@ -117,11 +143,6 @@ class GlobalPointer {
 
  private:
   uint64_t descriptor_ = 0;
-
-  inline executor_id home() const { return (executor_id)(descriptor_ >> 32); }
-  inline executor_id lsb() const {
-    return descriptor_ & (((uint64_t)1 << 32) - 1);
-  }
 };
 
 /*
@@ -131,15 +152,57 @@ class GlobalPointer {
  *
  ***************************************************************************
  */
-static uint64_t generate_lsb() {
-  static std::atomic<uint64_t> cnt{1};
-  return cnt++;
-}
-
-static GlobalPointer make_global(executor_id home) {
-  assert(home <= GlobalPointer::max_home);  // todo error reporting
-  return GlobalPointer(home, generate_lsb());
-}
+/**
+ * AddressGenerator generates the addresses homed at a single partition.
+ *
+ * Released offsets are kept in a FIFO free list and reused, with bumped
+ * generation, before fresh offsets are drawn.
+ * This keeps offsets (thus address-indexed tables) proportional to live
+ * addresses rather than to lifetime allocations, while spreading reuse
+ * among all the released offsets.
+ * An offset released at the last generation is retired, so that no address
+ * is ever reissued.
+ */
+class AddressGenerator {
+ public:
+  void home(executor_id h) {
+    assert(h <= GlobalPointer::max_home);  // todo error reporting
+    home_ = h;
+  }
+
+  executor_id home() const { return home_; }
+
+  GlobalPointer make() {
+    std::lock_guard<std::mutex> lg(mtx);
+    if (!free_list.empty()) {
+      GlobalPointer res(free_list.front());
+      free_list.pop_front();
+      return res;
+    }
+
+    assert(next_offset <= GlobalPointer::max_offset);  // todo error reporting
+    return GlobalPointer(home_, 0, next_offset++);
+  }
+
+  /*
+   * release an address, that must not be referenced anymore
+   */
+  void release(const GlobalPointer &p) {
+    assert(p.is_address());
+    assert(p.home() == home_);
+    if (p.generation() == GlobalPointer::max_generation) return;  // retired
+    uint64_t g = p.generation() + 1;
+
+    std::lock_guard<std::mutex> lg(mtx);
+    free_list.push_back(GlobalPointer(home_, g, p.offset()).address());
+  }
+
+ private:
+  executor_id home_ = 0;
+  uint64_t next_offset = 1;  // offset 0 is reserved (home 0 gen 0 is nullptr)
+  std::deque<uint64_t> free_list;
+  std::mutex mtx;
+};
 
 } /* namespace gam */
 
@@ -19,70 +19,111 @@
  */
 
 /**
- * @brief       a short description of the source file
+ * @brief       implements MemoryController class
+ *
+ * @ingroup internals
  *
  */
 #ifndef INCLUDE_GAM_MEMORYCONTROLLER_HPP_
 #define INCLUDE_GAM_MEMORYCONTROLLER_HPP_
 
 #include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <unordered_map>
 
+#include "gam/AtomicDirectory.hpp"
+#include "gam/GlobalPointer.hpp"
 #include "gam/Logger.hpp"
 
 namespace gam {
 
 /*
+ * MemoryController keeps the reference counts for public addresses the
+ * process is author of.
  *
+ * Authors are home for their addresses, and offsets generated by each home
+ * are dense and recycled, so counters are stored in place, indexed by offset,
+ * in a directory (see AtomicDirectory) of fixed-size segments.
+ * Once initialized, a counter is updated by a single atomic operation and
+ * the table is never mutated: segments are allocated by rc_init and retained
+ * until destruction.
  */
 class MemoryController {
  public:
-  inline void rc_init(uint64_t a) {
-    LOGLN("SMC init %llu", a);
+  MemoryController() {}
+
+  ~MemoryController() {
+    for (size_t i = 0; i < segs.size(); ++i) delete[] segs.load(i);
+  }
 
-    // mtx.lock();
-    assert(ref_cnt.find(a) == ref_cnt.end());
-    // mtx.unlock();
+  MemoryController(const MemoryController &) = delete;
+  MemoryController &operator=(const MemoryController &) = delete;
 
-    // mtx.lock();
-    ref_cnt[a].store(1);
-    // mtx.unlock();
+  inline void rc_init(uint64_t a) {
+    LOGLN("SMC init %llu", a);
+    obtain(a).store(1, std::memory_order_relaxed);
   }
 
   inline unsigned long long rc_inc(uint64_t a) {
-    // mtx.lock();
-    unsigned long long res = ++ref_cnt[a];
-    // mtx.unlock();
-
+    unsigned long long res = counter(a).fetch_add(1) + 1;
     LOGLN("SMC +1 %llu = %llu", a, res);
     return res;
   }
 
   inline unsigned long long rc_dec(uint64_t a) {
-    // mtx.lock();
-    unsigned long long res = --ref_cnt[a];
-    // mtx.unlock();
-
+    unsigned long long res = counter(a).fetch_sub(1) - 1;
     LOGLN("SMC -1 %llu = %llu", a, res);
     return res;
   }
 
   inline unsigned long long rc_get(uint64_t a) {
-    unsigned long long res = ref_cnt[a];
+    unsigned long long res = counter(a).load();
     LOGLN("SMC %llu = %llu", a, res);
     return res;
   }
 
  private:
+  typedef std::atomic<unsigned long long> counter_t;
+
+  static constexpr unsigned segment_bits = 12;
+  static constexpr size_t segment_size = (size_t)1 << segment_bits;
+
+  AtomicDirectory<counter_t> segs;
+  std::mutex grow_mtx;  // serializes directory writers
+
   /*
-   * Reference count, for each address the process is author of.
+   * locate the counter for a, that must have been initialized
    */
-  std::unordered_map<uint64_t, std::atomic<unsigned long long>> ref_cnt;
-  // std::mutex mtx;
+  counter_t &counter(uint64_t a) {
+    uint64_t o = GlobalPointer(a).offset();
+    counter_t *sg = segs.load(o >> segment_bits);
+    assert(sg != nullptr);
+    return sg[o & (segment_size - 1)];
+  }
+
+  /*
+   * locate the counter for a, allocating directory and segment if needed
+   */
+  counter_t &obtain(uint64_t a) {
+    uint64_t o = GlobalPointer(a).offset();
+    size_t s = o >> segment_bits;
+    counter_t *sg = segs.load(s);
+
+    if (!sg) {
+      std::lock_guard<std::mutex> lg(grow_mtx);
+      sg = segs.grow(s);
+      if (!sg) {
+        sg = new counter_t[segment_size];
+        for (size_t i = 0; i < segment_size; ++i)
+          sg[i].store(0, std::memory_order_relaxed);
+        segs.store(s, sg);
+      }
+    }
+
+    return sg[o & (segment_size - 1)];
+  }
 };
 
 } /* namespace gam */
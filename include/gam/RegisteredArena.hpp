@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       implements RegisteredArena class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_REGISTEREDARENA_HPP_
+#define INCLUDE_GAM_REGISTEREDARENA_HPP_
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "gam/Logger.hpp"
+#include "gam/ShardedMap.hpp"
+
+namespace gam {
+
+/**
+ * RegisteredArena reserves local memory in large regions, preferably backed
+ * by hugepages, that are registered once with the network layer.
+ * Any block carved out of a region can be transferred with no per-transfer
+ * registration, by passing the descriptor of its region.
+ *
+ * Small blocks are carved by the SlabAllocator out of arena memory, while
+ * large blocks are served directly by the arena, rounded up to a power of
+ * two and recycled through per-order free lists.
+ * Blocks too large for a shared region get a dedicated one, only rounded up
+ * to hugepages, that is unregistered and released on deallocation.
+ *
+ * Registration is performed by a registrar, attached by the network layer
+ * once it is ready: regions reserved earlier are registered upon attaching.
+ *
+ * Regions can be bound to a preferred NUMA node (see bind_node), so that
+ * local memory is served close to the CPUs the executor runs on.
+ *
+ * The instance is never destroyed, as SlabAllocator.
+ */
+class RegisteredArena {
+ public:
+  /**
+   * network-specific registration hooks
+   */
+  struct registrar {
+    /* register [base, base+len), setting handle and descriptor */
+    bool (*reg)(void *base, size_t len, void **handle, void **desc);
+    /* unregister a region by its handle */
+    void (*dereg)(void *handle);
+  };
+
+  static constexpr size_t region_size = (size_t)1 << 25;
+  static constexpr size_t huge_page = (size_t)1 << 21;
+  static constexpr unsigned min_large_order = 12;
+  static constexpr unsigned max_shared_order = 23;  // up to region_size / 4
+
+  static RegisteredArena &instance() {
+    /* constructed in place, never destroyed */
+    static typename std::aligned_storage<
+        sizeof(RegisteredArena), alignof(RegisteredArena)>::type storage;
+    static RegisteredArena *res = new (&storage) RegisteredArena();
+    return *res;
+  }
+
+  RegisteredArena(const RegisteredArena &) = delete;
+  RegisteredArena &operator=(const RegisteredArena &) = delete;
+
+  /*
+   ***************************************************************************
+   *
+   * registration
+   *
+   ***************************************************************************
+   */
+  /*
+   * attach a registrar, registering all the regions reserved so far
+   */
+  void attach(const registrar &r) {
+    std::lock_guard<std::mutex> lg(mtx);
+    std::lock_guard<rw_spinlock> wlg(regions_lock);
+    reg_ = r;
+    attached = true;
+    for (auto &rg : regions) do_register(rg);
+  }
+
+  /*
+   * unregister all regions and detach the registrar
+   */
+  void detach() {
+    std::lock_guard<std::mutex> lg(mtx);
+    std::lock_guard<rw_spinlock> wlg(regions_lock);
+    for (auto &rg : regions)
+      if (rg.handle) {
+        reg_.dereg(rg.handle);
+        rg.handle = rg.desc = nullptr;
+      }
+    attached = false;
+  }
+
+  /*
+   * the registration descriptor for the region holding p, if any
+   */
+  void *descriptor(const void *p) {
+    regions_lock.lock_shared();
+    void *res = nullptr;
+    const region *rg = find(p);
+    if (rg) res = rg->desc;
+    regions_lock.unlock_shared();
+    return res;
+  }
+
+  /*
+   * the registration handle and base of the region holding p, if registered
+   */
+  bool registration(const void *p, void *&handle, const char *&base) {
+    regions_lock.lock_shared();
+    const region *rg = find(p);
+    bool res = rg && rg->handle;
+    if (res) {
+      handle = rg->handle;
+      base = rg->base;
+    }
+    regions_lock.unlock_shared();
+    return res;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * NUMA placement
+   *
+   ***************************************************************************
+   */
+  /*
+   * prefer the given NUMA node for all the regions, migrating the pages of
+   * the regions reserved so far
+   */
+  void bind_node(int node) {
+    std::lock_guard<std::mutex> lg(mtx);
+    std::lock_guard<rw_spinlock> wlg(regions_lock);
+    numa_node = node;
+    for (auto &rg : regions) do_bind(rg, mpol_mf_move);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * allocation
+   *
+   ***************************************************************************
+   */
+  /*
+   * reserve len bytes (with 64-byte alignment), for good, or nullptr if no
+   * memory can be mapped
+   */
+  void *reserve(size_t len) {
+    std::lock_guard<std::mutex> lg(mtx);
+    return reserve_(len);
+  }
+
+  /*
+   * the order (i.e., log2 of the footprint) of a large block of len bytes
+   */
+  static unsigned large_order(size_t len) {
+    unsigned res = min_large_order;
+    while (((size_t)1 << res) < len) ++res;
+    return res;
+  }
+
+  /*
+   * serve a large block of at least len bytes, setting its order, or nullptr
+   * if no memory can be mapped
+   */
+  void *allocate_large(size_t len, unsigned &order) {
+    order = large_order(len);
+
+    std::lock_guard<std::mutex> lg(mtx);
+    if (order > max_shared_order) return new_region(len);
+
+    if (!free_lists[order].empty()) {
+      void *res = free_lists[order].back();
+      free_lists[order].pop_back();
+      return res;
+    }
+    return reserve_((size_t)1 << order);
+  }
+
+  void deallocate_large(void *p, unsigned order) {
+    std::lock_guard<std::mutex> lg(mtx);
+    if (order <= max_shared_order) {
+      free_lists[order].push_back(p);
+      return;
+    }
+
+    /* release the dedicated region */
+    std::lock_guard<rw_spinlock> wlg(regions_lock);
+    auto it = std::find_if(regions.begin(), regions.end(),
+                           [&](const region &rg) { return rg.base == p; });
+    assert(it != regions.end());
+    if (it->handle) reg_.dereg(it->handle);
+    munmap(it->base, it->len);
+    regions.erase(it);
+  }
+
+ private:
+  struct region {
+    char *base;
+    size_t len;
+    void *handle, *desc;
+  };
+
+  std::mutex mtx;  // protects allocation state
+  char *cur = nullptr, *cur_end = nullptr;
+  std::vector<void *> free_lists[sizeof(size_t) * 8];
+
+  rw_spinlock regions_lock;     // protects regions (sorted by base)
+  std::vector<region> regions;  // and registration state
+  registrar reg_{nullptr, nullptr};
+  bool attached = false;
+
+  /* mbind(2) constants, to avoid depending on libnuma headers */
+  static constexpr int mpol_preferred = 1;
+  static constexpr unsigned mpol_mf_move = 1 << 1;
+  static constexpr unsigned long max_numa_nodes = 1024;
+  int numa_node = -1;  // protected by both locks
+
+  RegisteredArena() {}
+
+  void *reserve_(size_t len) {
+    len = (len + 63) & ~(size_t)63;
+    if (len > region_size / 4) return new_region(len);
+
+    if ((size_t)(cur_end - cur) < len) {
+      char *p = (char *)new_region(region_size);
+      if (!p) return nullptr;
+      cur = p;
+      cur_end = cur + region_size;
+    }
+
+    void *res = cur;
+    cur += len;
+    return res;
+  }
+
+  /*
+   * map and register a fresh region, or return nullptr if mapping fails
+   */
+  void *new_region(size_t len) {
+    len = (len + huge_page - 1) & ~(huge_page - 1);
+    void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED) {
+      /* no reserved hugepages, fall back to transparent ones */
+      p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) {
+        LOGLN("ARN could not map region len=%zu", len);
+        return nullptr;
+      }
+#ifdef MADV_HUGEPAGE
+      madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+    LOGLN("ARN new region %p len=%zu", p, len);
+
+    region rg{(char *)p, len, nullptr, nullptr};
+    std::lock_guard<rw_spinlock> wlg(regions_lock);
+    do_bind(rg, 0);
+    if (attached) do_register(rg);
+    regions.insert(std::upper_bound(regions.begin(), regions.end(), rg,
+                                    [](const region &a, const region &b) {
+                                      return a.base < b.base;
+                                    }),
+                   rg);
+    return p;
+  }
+
+  void do_register(region &rg) {
+    if (!reg_.reg(rg.base, rg.len, &rg.handle, &rg.desc)) {
+      LOGLN("ARN could not register region %p", rg.base);
+      rg.handle = rg.desc = nullptr;
+    }
+  }
+
+  void do_bind(const region &rg, unsigned flags) {
+#ifdef SYS_mbind
+    if (numa_node < 0 || (unsigned long)numa_node >= max_numa_nodes) return;
+    const unsigned long bits = sizeof(unsigned long) * 8;
+    unsigned long mask[max_numa_nodes / bits] = {0};
+    mask[numa_node / bits] = 1UL << (numa_node % bits);
+    if (syscall(SYS_mbind, rg.base, rg.len, mpol_preferred, mask,
+                max_numa_nodes + 1, flags))
+      LOGLN("ARN could not bind region %p to node %d", rg.base, numa_node);
+#else
+    (void)rg;
+    (void)flags;
+#endif
+  }
+
+  /*
+   * the region holding p, with regions lock held
+   */
+  const region *find(const void *p) const {
+    auto it = std::upper_bound(
+        regions.begin(), regions.end(), (const char *)p,
+        [](const char *p_, const region &rg) { return p_ < rg.base; });
+    if (it == regions.begin()) return nullptr;
+    --it;
+    if ((const char *)p >= it->base + it->len) return nullptr;
+    return &*it;
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_REGISTEREDARENA_HPP_ */
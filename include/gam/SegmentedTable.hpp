@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @brief       implements SegmentedTable class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_SEGMENTEDTABLE_HPP_
+#define INCLUDE_GAM_SEGMENTEDTABLE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "gam/AtomicDirectory.hpp"
+#include "gam/GlobalPointer.hpp"
+
+namespace gam {
+
+/**
+ * SegmentedTable is a concurrent table indexed by global addresses.
+ *
+ * Since offsets generated by each home are dense, records are stored in
+ * place, in a two-level structure: a per-home directory of fixed-size
+ * segments, each holding 2^SegmentBits records.
+ * Locating a record costs a few pointer dereferences, with no hashing.
+ * Directories (see AtomicDirectory) grow on demand, segments are allocated
+ * on first write and retained until destruction.
+ *
+ * Addresses sharing the same offset (i.e., different generations) share the
+ * same slot: a slot matches only the exact address it was written for, and
+ * writing a different address evicts the former record, that is stale.
+ *
+ * Each record is protected by a sequence lock: lookups do not write shared
+ * memory, thus concurrent readers do not contend.
+ *
+ * The interface is the same as ShardedMap, restricted to uint64_t keys.
+ */
+template <typename T, unsigned SegmentBits = 12>
+class SegmentedTable {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SegmentedTable requires trivially copyable values");
+
+ public:
+  typedef uint64_t key_type;
+  typedef T mapped_type;
+  typedef size_t size_type;
+
+  SegmentedTable() {}
+
+  ~SegmentedTable() {
+    for (size_t h = 0; h < homes.size(); ++h) {
+      home_t *ho = homes.load(h);
+      if (!ho) continue;
+      for (size_t s = 0; s < ho->segs.size(); ++s) delete ho->segs.load(s);
+      delete ho;
+    }
+  }
+
+  SegmentedTable(const SegmentedTable &) = delete;
+  SegmentedTable &operator=(const SegmentedTable &) = delete;
+
+  /*
+   * call f(const T &) on the value for k, if any
+   *
+   * @retval TRUE if k was found
+   */
+  template <typename F>
+  bool read(const key_type &k, F &&f) {
+    slot *s = lookup(k);
+    record r;
+    if (!s || !load(*s, r) || r.key != k) return false;
+    f(static_cast<const T &>(r.value));
+    return true;
+  }
+
+  /*
+   * call f(T &) on the value for k, default-inserting it if missing
+   */
+  template <typename F>
+  void write(const key_type &k, F &&f) {
+    slot &s = obtain(k);
+    lock(s);
+    if (!s.r.used || s.r.key != k) {
+      s.r.value = T();
+      s.r.key = k;
+      s.r.used = true;
+    }
+    f(s.r.value);
+    unlock(s);
+  }
+
+  bool contains(const key_type &k) {
+    return read(k, [](const T &) {});
+  }
+
+  size_type erase(const key_type &k) {
+    T out;
+    return erase(k, out) ? 1 : 0;
+  }
+
+  /*
+   * erase the entry for k, moving its value to out
+   *
+   * @retval TRUE if k was found
+   */
+  bool erase(const key_type &k, T &out) {
+    slot *s = lookup(k);
+    if (!s) return false;
+    lock(*s);
+    bool res = s->r.used && s->r.key == k;
+    if (res) {
+      out = s->r.value;
+      s->r.value = T();
+      s->r.used = false;
+    }
+    unlock(*s);
+    return res;
+  }
+
+  bool empty() {
+    bool res = true;
+    for_each([&](const key_type &, const T &) { res = false; });
+    return res;
+  }
+
+  /*
+   * call f(const key_type &, const T &) on each entry
+   */
+  template <typename F>
+  void for_each(F &&f) {
+    for (size_t h = 0; h < homes.size(); ++h) {
+      home_t *ho = homes.load(h);
+      if (!ho) continue;
+      for (size_t s = 0; s < ho->segs.size(); ++s) {
+        segment *sg = ho->segs.load(s);
+        if (!sg) continue;
+        for (size_t i = 0; i < segment_size; ++i) {
+          record r;
+          if (load(sg->slots[i], r))
+            f(static_cast<const key_type &>(r.key),
+              static_cast<const T &>(r.value));
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t segment_size = (size_t)1 << SegmentBits;
+
+  struct record {
+    bool used = false;
+    key_type key = 0;
+    T value;
+  };
+
+  struct slot {
+    std::atomic<uint32_t> seq{0};  // odd while being written
+    record r;
+  };
+
+  struct segment {
+    slot slots[segment_size];
+  };
+
+  struct home_t {
+    AtomicDirectory<segment> segs;
+  };
+
+  AtomicDirectory<home_t> homes;
+  std::mutex grow_mtx;  // serializes directory writers
+
+  static size_t home_of(key_type k) { return GlobalPointer(k).home(); }
+
+  static size_t lsb_of(key_type k) { return GlobalPointer(k).offset(); }
+
+  /*
+   * locate the slot for k, without allocating
+   */
+  slot *lookup(key_type k) {
+    home_t *ho = homes.load(home_of(k));
+    if (!ho) return nullptr;
+
+    segment *sg = ho->segs.load(lsb_of(k) >> SegmentBits);
+    if (!sg) return nullptr;
+
+    return &sg->slots[lsb_of(k) & (segment_size - 1)];
+  }
+
+  /*
+   * locate the slot for k, allocating directories and segments if needed
+   */
+  slot &obtain(key_type k) {
+    slot *res = lookup(k);
+    if (res) return *res;
+
+    std::lock_guard<std::mutex> lg(grow_mtx);
+    size_t h = home_of(k), s = lsb_of(k) >> SegmentBits;
+
+    home_t *ho = homes.grow(h);
+    if (!ho) {
+      ho = new home_t();
+      homes.store(h, ho);
+    }
+
+    segment *sg = ho->segs.grow(s);
+    if (!sg) {
+      sg = new segment();
+      ho->segs.store(s, sg);
+    }
+
+    return sg->slots[lsb_of(k) & (segment_size - 1)];
+  }
+
+  /*
+   * sequence-lock protocol
+   */
+  static void lock(slot &s) {
+    unsigned spins = 0;
+    while (true) {
+      uint32_t v = s.seq.load(std::memory_order_relaxed);
+      if (!(v & 1) &&
+          s.seq.compare_exchange_weak(v, v + 1, std::memory_order_acquire))
+        break;
+      backoff(spins);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  static void unlock(slot &s) { s.seq.fetch_add(1, std::memory_order_release); }
+
+  /*
+   * consistent snapshot of a slot
+   *
+   * @retval TRUE if the slot is in use, in which case r holds its record
+   */
+  static bool load(slot &s, record &r) {
+    unsigned spins = 0;
+    while (true) {
+      uint32_t v0 = s.seq.load(std::memory_order_acquire);
+      if (!(v0 & 1)) {
+        r = s.r;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) == v0) return r.used;
+      }
+      backoff(spins);
+    }
+  }
+
+  static void backoff(unsigned &spins) {
+    if (++spins > 64) {
+      std::this_thread::yield();
+      spins = 0;
+    }
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_SEGMENTEDTABLE_HPP_ */
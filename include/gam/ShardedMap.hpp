@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @brief       implements ShardedMap class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_SHARDEDMAP_HPP_
+#define INCLUDE_GAM_SHARDEDMAP_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace gam {
+
+/**
+ * A reader-writer spinlock.
+ * Readers only pay one atomic increment, writers take precedence over incoming
+ * readers.
+ */
+class rw_spinlock {
+ public:
+  void lock_shared() {
+    unsigned spins = 0;
+    while (true) {
+      /* optimistically register as reader, step back if a writer is in */
+      if (!(state.fetch_add(1, std::memory_order_acquire) & writer)) return;
+      state.fetch_sub(1, std::memory_order_relaxed);
+      while (state.load(std::memory_order_relaxed) & writer) backoff(spins);
+    }
+  }
+
+  void unlock_shared() { state.fetch_sub(1, std::memory_order_release); }
+
+  void lock() {
+    unsigned spins = 0;
+
+    /* announce the writer */
+    while (true) {
+      uint32_t s = state.load(std::memory_order_relaxed);
+      if (!(s & writer) && state.compare_exchange_weak(
+                               s, s | writer, std::memory_order_acquire))
+        break;
+      backoff(spins);
+    }
+
+    /* wait for inflight readers */
+    while (state.load(std::memory_order_acquire) != writer) backoff(spins);
+  }
+
+  void unlock() { state.fetch_and(~writer, std::memory_order_release); }
+
+ private:
+  static constexpr uint32_t writer = (uint32_t)1 << 31;
+  std::atomic<uint32_t> state{0};
+
+  static void backoff(unsigned &spins) {
+    if (++spins > 64) {
+      std::this_thread::yield();
+      spins = 0;
+    }
+  }
+};
+
+/**
+ * ShardedMap is a concurrent hash map, split into 2^ShardBits independently
+ * locked shards.
+ *
+ * Lookups take a shared lock on a single shard, thus concurrent readers never
+ * exclude each other.
+ * Values are accessed through callbacks executed under the shard lock, so that
+ * no reference escapes the critical section.
+ * Callbacks must not access the map.
+ */
+template <typename Key, typename T, unsigned ShardBits = 6>
+class ShardedMap {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef size_t size_type;
+
+  /*
+   * call f(const T &) on the value for k, if any
+   *
+   * @retval TRUE if k was found
+   */
+  template <typename F>
+  bool read(const key_type &k, F &&f) {
+    shard &s = shard_of(k);
+    s.lck.lock_shared();
+    auto it = s.map.find(k);
+    bool res = (it != s.map.end());
+    if (res) f(static_cast<const T &>(it->second));
+    s.lck.unlock_shared();
+    return res;
+  }
+
+  /*
+   * call f(T &) on the value for k, default-inserting it if missing
+   */
+  template <typename F>
+  void write(const key_type &k, F &&f) {
+    shard &s = shard_of(k);
+    std::lock_guard<rw_spinlock> lg(s.lck);
+    f(s.map[k]);
+  }
+
+  bool contains(const key_type &k) {
+    return read(k, [](const T &) {});
+  }
+
+  size_type erase(const key_type &k) {
+    shard &s = shard_of(k);
+    std::lock_guard<rw_spinlock> lg(s.lck);
+    return s.map.erase(k);
+  }
+
+  /*
+   * erase the entry for k, moving its value to out
+   *
+   * @retval TRUE if k was found
+   */
+  bool erase(const key_type &k, T &out) {
+    shard &s = shard_of(k);
+    std::lock_guard<rw_spinlock> lg(s.lck);
+    auto it = s.map.find(k);
+    if (it == s.map.end()) return false;
+    out = std::move(it->second);
+    s.map.erase(it);
+    return true;
+  }
+
+  bool empty() {
+    for (auto &s : shards) {
+      s.lck.lock_shared();
+      bool res = s.map.empty();
+      s.lck.unlock_shared();
+      if (!res) return false;
+    }
+    return true;
+  }
+
+  /*
+   * call f(const Key &, const T &) on each entry, one shard at a time
+   */
+  template <typename F>
+  void for_each(F &&f) {
+    for (auto &s : shards) {
+      s.lck.lock_shared();
+      for (auto &kv : s.map) f(kv.first, static_cast<const T &>(kv.second));
+      s.lck.unlock_shared();
+    }
+  }
+
+ private:
+  static constexpr size_t n_shards = (size_t)1 << ShardBits;
+
+  /*
+   * fibonacci hashing, spreads both dense counters and aligned pointers.
+   * Shards are selected by the high bits, buckets by the whole hash, so that
+   * keys falling into the same shard do not cluster within the shard.
+   */
+  struct mix_hash {
+    size_t operator()(const key_type &k) const {
+      return (size_t)((uint64_t)std::hash<Key>()(k) * 0x9E3779B97F4A7C15ull);
+    }
+  };
+
+  struct alignas(64) shard {
+    rw_spinlock lck;
+    std::unordered_map<Key, T, mix_hash> map;
+  };
+
+  shard shards[n_shards];
+
+  shard &shard_of(const key_type &k) {
+    return shards[(uint64_t)mix_hash()(k) >> (64 - ShardBits)];
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_SHARDEDMAP_HPP_ */
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       implements SlabAllocator class
+ *
+ * @ingroup internals
+ *
+ */
+#ifndef INCLUDE_GAM_SLABALLOCATOR_HPP_
+#define INCLUDE_GAM_SLABALLOCATOR_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "gam/RegisteredArena.hpp"
+
+namespace gam {
+
+/**
+ * SlabAllocator is a process-wide size-class allocator for small blocks.
+ *
+ * Blocks of each size class are carved out of fixed-size slabs and recycled
+ * through per-thread caches, thus allocation and deallocation are a few
+ * non-atomic operations on the fast path.
+ * Caches exchange batches of blocks with a per-class depot, protected by a
+ * mutex, when they run empty or grow beyond a threshold.
+ * A thread may free blocks allocated by another thread.
+ *
+ * Slabs are carved out of the RegisteredArena, thus blocks can be transferred
+ * with no further registration.
+ * Slabs are never returned to the arena, and the instance is never
+ * destroyed, so that blocks can be freed at any time up to process exit.
+ */
+class SlabAllocator {
+ public:
+  static constexpr unsigned n_classes = 16;
+
+  /* size class of blocks larger than max_block_size */
+  static constexpr unsigned large_class = n_classes;
+
+  static constexpr size_t max_block_size = 2048;
+
+  static SlabAllocator &instance() {
+    /* constructed in place, never destroyed */
+    static typename std::aligned_storage<sizeof(SlabAllocator),
+                                         alignof(SlabAllocator)>::type storage;
+    static SlabAllocator *res = new (&storage) SlabAllocator();
+    return *res;
+  }
+
+  SlabAllocator(const SlabAllocator &) = delete;
+  SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+  /*
+   * the smallest size class holding size bytes, or large_class
+   */
+  static unsigned size_class(size_t size) {
+    if (size <= 128) return size ? (unsigned)((size - 1) >> 4) : 0;
+    for (unsigned c = 8; c < n_classes; ++c)
+      if (size <= block_size(c)) return c;
+    return large_class;
+  }
+
+  /*
+   * 16-byte steps up to 128 bytes, then two classes per power of two
+   */
+  static size_t block_size(unsigned c) {
+    assert(c < n_classes);
+    if (c < 8) return (size_t)(c + 1) << 4;
+    size_t p = (size_t)128 << ((c - 8) / 2);
+    return (c % 2) ? 2 * p : p + p / 2;
+  }
+
+  void *allocate(unsigned c) {
+    assert(c < n_classes);
+    thread_cache *tc = local_cache();
+    if (!tc) return global_allocate(c);
+
+    bin &b = tc->bins[c];
+    if (!b.head) refill(b, c);
+    free_block *res = b.head;
+    b.head = res->next;
+    --b.count;
+    bump(tc->allocs[c]);
+    return res;
+  }
+
+  void deallocate(void *p, unsigned c) {
+    assert(c < n_classes);
+    thread_cache *tc = local_cache();
+    if (!tc) return global_deallocate(p, c);
+
+    bin &b = tc->bins[c];
+    free_block *fb = (free_block *)p;
+    fb->next = b.head;
+    b.head = fb;
+    if (++b.count > 2 * batch) spill(b, c, batch);
+    bump(tc->frees[c]);
+  }
+
+  /**
+   * statistics for a size class
+   */
+  struct class_stats {
+    size_t block_size;
+    unsigned long long allocs, frees;  // total operations
+    unsigned long long slabs;          // slabs carved so far
+  };
+
+  /*
+   * a snapshot of the statistics for each size class
+   */
+  std::vector<class_stats> stats() {
+    std::vector<class_stats> res(n_classes);
+    std::lock_guard<std::mutex> lg(registry_mtx);
+    for (unsigned c = 0; c < n_classes; ++c) {
+      res[c].block_size = block_size(c);
+      res[c].allocs = depots[c].allocs.load(std::memory_order_relaxed);
+      res[c].frees = depots[c].frees.load(std::memory_order_relaxed);
+      res[c].slabs = depots[c].slabs.load(std::memory_order_relaxed);
+      for (auto tc : caches) {
+        res[c].allocs += tc->allocs[c].load(std::memory_order_relaxed);
+        res[c].frees += tc->frees[c].load(std::memory_order_relaxed);
+      }
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t slab_size = (size_t)1 << 16;
+
+  /* blocks moved at once between caches and depots */
+  static constexpr unsigned batch = 32;
+
+  struct free_block {
+    free_block *next;
+  };
+
+  struct bin {
+    free_block *head = nullptr;
+    unsigned count = 0;
+  };
+
+  /*
+   * counters are only written by the owner thread, and read by stats()
+   */
+  typedef std::atomic<unsigned long long> counter_t;
+
+  struct thread_cache {
+    bin bins[n_classes];
+    counter_t allocs[n_classes], frees[n_classes];
+
+    thread_cache() {
+      for (unsigned c = 0; c < n_classes; ++c) {
+        allocs[c].store(0, std::memory_order_relaxed);
+        frees[c].store(0, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  struct alignas(64) depot {
+    std::mutex mtx;
+    free_block *head = nullptr;
+    counter_t allocs{0}, frees{0};  // from retired caches and late frees
+    counter_t slabs{0};
+  };
+
+  depot depots[n_classes];
+  std::vector<thread_cache *> caches;
+  std::mutex registry_mtx;
+
+  SlabAllocator() {}
+
+  static void bump(counter_t &c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * per-thread caches
+   *
+   ***************************************************************************
+   */
+  /*
+   * flushes the cache of a thread upon its termination
+   */
+  struct cache_holder {
+    thread_cache *tc = nullptr;
+
+    ~cache_holder() {
+      cache_ptr() = dead_cache();
+      if (tc) instance().retire(tc);
+    }
+  };
+
+  static thread_cache *&cache_ptr() {
+    static thread_local thread_cache *res = nullptr;
+    return res;
+  }
+
+  static thread_cache *dead_cache() { return (thread_cache *)1; }
+
+  /*
+   * the cache of the calling thread, or nullptr if the thread is terminating
+   */
+  thread_cache *local_cache() {
+    thread_cache *res = cache_ptr();
+    if (res == dead_cache()) return nullptr;
+    if (res) return res;
+
+    static thread_local cache_holder holder;
+    res = holder.tc = new thread_cache();
+    cache_ptr() = res;
+
+    std::lock_guard<std::mutex> lg(registry_mtx);
+    caches.push_back(res);
+    return res;
+  }
+
+  void retire(thread_cache *tc) {
+    for (unsigned c = 0; c < n_classes; ++c)
+      if (tc->bins[c].count) spill(tc->bins[c], c, tc->bins[c].count);
+
+    std::lock_guard<std::mutex> lg(registry_mtx);
+    for (unsigned c = 0; c < n_classes; ++c) {
+      depots[c].allocs.fetch_add(tc->allocs[c].load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+      depots[c].frees.fetch_add(tc->frees[c].load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < caches.size(); ++i)
+      if (caches[i] == tc) {
+        caches[i] = caches.back();
+        caches.pop_back();
+        break;
+      }
+    delete tc;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * depots
+   *
+   ***************************************************************************
+   */
+  /*
+   * move up to a batch of blocks from the depot to b, carving a new slab if
+   * the depot is empty
+   */
+  void refill(bin &b, unsigned c) {
+    depot &d = depots[c];
+    std::lock_guard<std::mutex> lg(d.mtx);
+    if (!d.head) carve(d, c);
+
+    unsigned n = 0;
+    free_block *last = d.head;
+    while (++n < batch && last->next) last = last->next;
+    b.head = d.head;
+    d.head = last->next;
+    last->next = nullptr;
+    b.count = n;
+  }
+
+  /*
+   * move the first n blocks of b to the depot
+   */
+  void spill(bin &b, unsigned c, unsigned n) {
+    assert(n > 0 && n <= b.count);
+    free_block *first = b.head, *last = b.head;
+    for (unsigned i = 1; i < n; ++i) last = last->next;
+    b.head = last->next;
+    b.count -= n;
+
+    depot &d = depots[c];
+    std::lock_guard<std::mutex> lg(d.mtx);
+    last->next = d.head;
+    d.head = first;
+  }
+
+  /*
+   * carve a fresh slab into the (empty) depot
+   */
+  void carve(depot &d, unsigned c) {
+    size_t bs = block_size(c), n = slab_size / bs;
+    char *slab = (char *)RegisteredArena::instance().reserve(n * bs);
+    if (!slab) throw std::bad_alloc();
+    d.slabs.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < n; ++i) {
+      free_block *fb = (free_block *)(slab + i * bs);
+      fb->next = d.head;
+      d.head = fb;
+    }
+  }
+
+  /*
+   * slow paths for threads past their cache lifetime
+   */
+  void *global_allocate(unsigned c) {
+    depot &d = depots[c];
+    std::lock_guard<std::mutex> lg(d.mtx);
+    if (!d.head) carve(d, c);
+    free_block *res = d.head;
+    d.head = res->next;
+    d.allocs.fetch_add(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  void global_deallocate(void *p, unsigned c) {
+    depot &d = depots[c];
+    std::lock_guard<std::mutex> lg(d.mtx);
+    free_block *fb = (free_block *)p;
+    fb->next = d.head;
+    d.head = fb;
+    d.frees.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_SLABALLOCATOR_HPP_ */
@@ -27,25 +27,36 @@
 #ifndef INCLUDE_GAM_TRACKINGALLOCATOR_HPP_
 #define INCLUDE_GAM_TRACKINGALLOCATOR_HPP_
 
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
 #include <mutex>
 #include <unordered_map>
 
-#include "gam/ConcurrentMapWrap.hpp"
-
 namespace gam {
 
 /**
  * A naive concurrent allocator with leak tracking, in form of singleton class.
+ *
+ * Each block is tracked along with its size, each operation takes the lock
+ * once.
+ * Live usage is accounted (in production as well) by the Accounting layer,
+ * this class only adds pointer-exact leak detection in debug builds.
  */
 class TrackingAllocator {
   enum alloc_op { MALLOC_ = 0, NEW_ = 1 };
-  typedef ConcurrentMapWrap<std::unordered_map<void *, alloc_op>> alloc_map_t;
+
+  struct block {
+    alloc_op op;
+    size_t size;
+  };
 
  public:
   ~TrackingAllocator() {
     if (!inflight.empty()) {
       for (auto it : inflight)
-        fprintf(stderr, "ALC %p %d\n", it.first, it.second);
+        fprintf(stderr, "ALC %p %d size=%zu\n", it.first, it.second.op,
+                it.second.size);
       assert(false);
     }
   }
@@ -54,13 +65,10 @@ class TrackingAllocator {
     void *res = ::malloc(size);
     assert(res);
 
-    mtx.lock();
-    assert(inflight.find(res) == inflight.end());
-    mtx.unlock();
-
-    mtx.lock();
-    inflight[res] = MALLOC_;
-    mtx.unlock();
+    std::lock_guard<std::mutex> lg(mtx);
+    bool fresh = inflight.emplace(res, block{MALLOC_, size}).second;
+    assert(fresh);
+    (void)fresh;
 
     return res;
   }
@@ -68,58 +76,35 @@ class TrackingAllocator {
   void free(void *p) {
     assert(p != nullptr);
 
-    mtx.lock();
-    assert(inflight.find(p) != inflight.end());
-    mtx.unlock();
-
-    mtx.lock();
-    assert(inflight[p] == MALLOC_);
-    mtx.unlock();
-
-    mtx.lock();
-    alloc_map_t::size_type res = inflight.erase(p);
-    mtx.unlock();
-
-    assert(res > 0);
+    {
+      std::lock_guard<std::mutex> lg(mtx);
+      auto it = inflight.find(p);
+      assert(it != inflight.end());
+      assert(it->second.op == MALLOC_);
+      inflight.erase(it);
+    }
 
     ::free(p);
   }
 
-  void new_(void *p) {
-    assert(p != nullptr);
-
-    mtx.lock();
-    assert(inflight.find(p) != inflight.end());
-    mtx.unlock();
+  void new_(void *p) { transition(p, MALLOC_, NEW_); }
 
-    mtx.lock();
-    assert(inflight[p] == MALLOC_);
-    mtx.unlock();
+  void delete_(void *p) { transition(p, NEW_, MALLOC_); }
 
-    mtx.lock();
-    inflight[p] = NEW_;
-    mtx.unlock();
-  }
+ private:
+  std::mutex mtx;
+  std::unordered_map<void *, block> inflight;
 
-  void delete_(void *p) {
+  void transition(void *p, alloc_op from, alloc_op to) {
     assert(p != nullptr);
 
-    mtx.lock();
-    assert(inflight.find(p) != inflight.end());
-    mtx.unlock();
-
-    mtx.lock();
-    assert(inflight[p] == NEW_);
-    mtx.unlock();
-
-    mtx.lock();
-    inflight[p] = MALLOC_;
-    mtx.unlock();
+    std::lock_guard<std::mutex> lg(mtx);
+    auto it = inflight.find(p);
+    assert(it != inflight.end());
+    assert(it->second.op == from);
+    it->second.op = to;
+    (void)from;
   }
-
- private:
-  std::mutex mtx;
-  alloc_map_t inflight;
 };
 
 }  // namespace gam
@@ -29,24 +29,51 @@
 #ifndef INCLUDE_GAM_VIEW_HPP_
 #define INCLUDE_GAM_VIEW_HPP_
 
-#include <mutex>
 #include <sstream>
-#include <unordered_map>
+#include <utility>
 
 #include "gam/backend_ptr.hpp"
-#include "gam/ConcurrentMapWrap.hpp"
 #include "gam/defs.hpp"
 #include "gam/GlobalPointer.hpp"
+#include "gam/SegmentedTable.hpp"
+#include "gam/ShardedMap.hpp"
 
 namespace gam {
 
+/*
+ * backend for the per-address records:
+ * - SegmentedTable (default) directly indexed by (home, lsb)
+ * - ShardedMap if GAM_VIEW_HASHED is defined
+ */
+#ifdef GAM_VIEW_HASHED
+template <typename T>
+using address_table = ShardedMap<uint64_t, T>;
+#else
+template <typename T>
+using address_table = SegmentedTable<T>;
+#endif
+
 /**
  * View represents the global memory state as perceived by a single executor.
  *
+ * Tables are concurrent, so that lookups from the user and daemon threads do
+ * not exclude each other.
+ *
  * @brief global memory as perceived by a single executor
  */
 class View {
  public:
+  /**
+   * the record associated to a global address
+   */
+  struct entry {
+    backend_ptr *committed = nullptr;
+    void *child = nullptr;
+    executor_id owner = 0, author = 0;
+    AccessLevel access_level = AL_PUBLIC;
+    bool linked = false;  // child linked to its parent by allocation header
+  };
+
   /*
    ***************************************************************************
    *
@@ -55,34 +82,78 @@ class View {
    ***************************************************************************
    */
   ~View() {
-    for (auto it = view_map.begin(); it != view_map.end(); ++it) {
+    view_map.for_each([](const uint64_t, const entry &e) {
       /* check no spurious committed copies */
-      assert(it->second.committed == nullptr);
-    }
+      assert(e.committed == nullptr);
+    });
   }
 
   /*
    ***************************************************************************
    *
-   * getters block
+   * record-level access block
+   *
+   * Each function performs a single table lookup, thus it is preferable to
+   * a sequence of field getters/setters on the same address.
    *
    ***************************************************************************
    */
-  inline backend_ptr *committed(const uint64_t a) {
-    return view_map[a].committed;
+  /*
+   * non-inserting lookup
+   *
+   * @retval TRUE if a is mapped, in which case e is filled with its record
+   */
+  inline bool find(const uint64_t a, entry &e) {
+    return view_map.read(a, [&](const entry &e_) { e = e_; });
+  }
+
+  /*
+   * returns the record for a, that must be mapped
+   */
+  inline entry record(const uint64_t a) {
+    entry res;
+    bool found = find(a, res);
+    assert(found);
+    (void)found;
+    return res;
   }
 
+  /*
+   * calls f(entry &) on the record for a, inserting a fresh record if missing
+   */
+  template <typename F>
+  inline void update(const uint64_t a, F &&f) {
+    view_map.write(a, std::forward<F>(f));
+    LOGLN("VW  update record=%llu", a);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * getters block
+   *
+   * Getters do not insert missing records, rather they return the fields of a
+   * fresh record.
+   *
+   ***************************************************************************
+   */
+  inline backend_ptr *committed(const uint64_t a) { return get(a).committed; }
+
   inline AccessLevel access_level(const uint64_t a) {
-    return view_map[a].access_level;
+    return get(a).access_level;
   }
 
-  inline executor_id owner(const uint64_t a) { return view_map[a].owner; }
+  inline executor_id owner(const uint64_t a) { return get(a).owner; }
 
-  inline executor_id author(const uint64_t a) { return view_map[a].author; }
+  inline executor_id author(const uint64_t a) { return get(a).author; }
 
-  inline uint64_t parent(void *const c) { return parent_map[c]; }
+  inline uint64_t parent(void *const c) {
+    uint64_t res = 0;
+    parent_map.read(c, [&](const uint64_t &a) { res = a; });
+    return res;
+  }
 
-  inline void *child(const uint64_t a) { return view_map[a].child; }
+  inline void *child(const uint64_t a) { return get(a).child; }
 
   /*
    ***************************************************************************
@@ -91,17 +162,11 @@ class View {
    *
    ***************************************************************************
    */
-  inline bool has_parent(void *const c) {
-    return (parent_map.find(c) != parent_map.end());
-  }
+  inline bool has_parent(void *const c) { return parent_map.contains(c); }
 
-  inline bool has_child(const uint64_t a) {
-    return (view_map[a].child != nullptr);
-  }
+  inline bool has_child(const uint64_t a) { return (get(a).child != nullptr); }
 
-  inline bool mapped(const uint64_t a) {
-    return (view_map.find(a) != view_map.end());
-  }
+  inline bool mapped(const uint64_t a) { return view_map.contains(a); }
 
   /*
    ***************************************************************************
@@ -111,32 +176,32 @@ class View {
    ***************************************************************************
    */
   inline void bind_committed(const uint64_t a, backend_ptr *const p) {
-    view_map[a].committed = p;
+    view_map.write(a, [&](entry &e) { e.committed = p; });
     LOGLN("VW  bind committed: %llu -> %p", a, p);
   }
 
   inline void bind_access_level(const uint64_t a, const AccessLevel a_) {
-    view_map[a].access_level = a_;
+    view_map.write(a, [&](entry &e) { e.access_level = a_; });
     LOGLN("VW  bind access level: %llu -> %d", a, a_);
   }
 
   inline void bind_owner(const uint64_t a, const executor_id o) {
-    view_map[a].owner = o;
+    view_map.write(a, [&](entry &e) { e.owner = o; });
     LOGLN("VW  bind owner: %llu -> %lu", a, o);
   }
 
   inline void bind_author(const uint64_t a, const executor_id a_) {
-    view_map[a].author = a_;
+    view_map.write(a, [&](entry &e) { e.author = a_; });
     LOGLN("VW  bind author: %llu -> %lu", a, a_);
   }
 
   inline void bind_parent(void *const c, const uint64_t a) {
-    parent_map[c] = a;
+    parent_map.write(c, [&](uint64_t &a_) { a_ = a; });
     LOGLN("VW  bind parent: %p -> %llu", c, a);
   }
 
   inline void bind_child(const uint64_t a, void *const c) {
-    view_map[a].child = c;
+    view_map.write(a, [&](entry &e) { e.child = c; });
     LOGLN("VW  bind child: %llu -> %p", a, c);
   }
 
@@ -149,17 +214,30 @@ class View {
    */
 
   inline void unmap(const uint64_t a) {
-    assert(view_map.find(a) != view_map.end());
+    auto res = view_map.erase(a);
+    assert(res > 0);
+    (void)res;
 
-    view_map.erase(a);
+    LOGLN("VW  cleared record=%llu", a);
+  }
+
+  /*
+   * clears the record for a, that must be mapped, and returns it
+   */
+  inline entry unmap_record(const uint64_t a) {
+    entry res;
+    bool found = view_map.erase(a, res);
+    assert(found);
+    (void)found;
 
     LOGLN("VW  cleared record=%llu", a);
+    return res;
   }
 
   inline void unbind_parent(void *const c) {
-    assert(has_parent(c));
-
-    parent_map.erase(c);
+    auto res = parent_map.erase(c);
+    assert(res > 0);
+    (void)res;
 
     LOGLN("VW  cleared parent for=%p", c);
   }
@@ -180,15 +258,19 @@ class View {
   }
 
  private:
-  struct entry {
-    backend_ptr *committed = nullptr;
-    void *child = nullptr;
-    executor_id owner, author;
-    AccessLevel access_level;
-  };
+  address_table<entry> view_map;
+
+  /* parenthood, only for children not allocated by the Context */
+  ShardedMap<void *, uint64_t> parent_map;
 
-  ConcurrentMapWrap<std::unordered_map<uint64_t, entry>> view_map;
-  ConcurrentMapWrap<std::unordered_map<void *, uint64_t>> parent_map;
+  /*
+   * copy of the record for a, or a fresh record if missing
+   */
+  inline entry get(const uint64_t a) {
+    entry res;
+    find(a, res);
+    return res;
+  }
 };
 
 } /* namespace gam */
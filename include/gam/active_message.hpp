@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       handlers of active messages, executed where the data lives
+ *
+ * @ingroup internals
+ *
+ * A handler is a function taking the target object by reference, followed
+ * by any number of arguments, e.g.:
+ *
+ *   long count_in(const std::vector<int> &v, int lo, int hi);
+ *
+ * and is identified at compile time by GAM_HANDLER(count_in).
+ * Arguments and results travel as frames, so they can be of any type
+ * supported by marshalling (see marshalling.hpp).
+ * Handlers taking the target object by non-const reference may update it,
+ * hence they only apply to owned private memory: public memory is read by
+ * its holders with no synchronization with handlers.
+ *
+ * Handlers are run by the author of the target object, one at a time, and
+ * must not operate on global pointers themselves.
+ */
+#ifndef INCLUDE_GAM_ACTIVE_MESSAGE_HPP_
+#define INCLUDE_GAM_ACTIVE_MESSAGE_HPP_
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "gam/marshalling.hpp"
+#include "gam/registry.hpp"
+
+/**
+ * @brief the compile-time identifier of handler f
+ */
+#define GAM_HANDLER(f) decltype(&f), &f
+
+namespace gam {
+
+/*
+ * type-erased handler: unpack arguments, run, pack the result into reply
+ */
+using am_fn = frame_header (*)(void *obj, const char *args,
+                               const frame_header &h, frame_buffer &reply);
+using am_registry = registry<am_fn>;
+
+template <size_t... I>
+struct indices {};
+
+template <size_t N, size_t... I>
+struct make_indices : make_indices<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_indices<0, I...> {
+  using type = indices<I...>;
+};
+
+template <typename F, F f>
+struct am_handler;
+
+template <typename R, typename T, typename... Params, R (*f)(T &, Params...)>
+struct am_handler<R (*)(T &, Params...), f> {
+  using object_type = typename std::remove_const<T>::type;
+  using result_type = R;
+  using args_type = std::tuple<typename std::decay<Params>::type...>;
+  static constexpr bool mutating = !std::is_const<T>::value;
+
+  static R call(void *obj, args_type &args) {
+    return call(obj, args, typename make_indices<sizeof...(Params)>::type{});
+  }
+
+  static frame_header run(void *obj, const char *frame, const frame_header &h,
+                          frame_buffer &reply) {
+    args_type args;
+    unpack_object(args, frame, h);
+    return reply_of(obj, args, reply, std::is_void<R>{});
+  }
+
+  static const uint64_t key;  // registered at static initialization
+
+ private:
+  template <size_t... I>
+  static R call(void *obj, args_type &args, indices<I...>) {
+    return f(*static_cast<T *>(obj), std::get<I>(args)...);
+  }
+
+  static frame_header reply_of(void *obj, args_type &args, frame_buffer &,
+                               std::true_type) {
+    call(obj, args);
+    return frame_header{0, 0};
+  }
+
+  static frame_header reply_of(void *obj, args_type &args, frame_buffer &reply,
+                               std::false_type) {
+    R res = call(obj, args);
+    return pack_object(res, reply);
+  }
+};
+
+template <typename R, typename T, typename... Params, R (*f)(T &, Params...)>
+const uint64_t am_handler<R (*)(T &, Params...), f>::key = am_registry::add(
+    signature_key<am_handler<R (*)(T &, Params...), f>>(),
+    &am_handler<R (*)(T &, Params...), f>::run);
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_ACTIVE_MESSAGE_HPP_ */
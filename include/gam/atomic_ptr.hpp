@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @brief       implements atomic_ptr class and generators
+ *
+ * @ingroup api
+ *
+ */
+#ifndef INCLUDE_GAM_ATOMIC_PTR_HPP_
+#define INCLUDE_GAM_ATOMIC_PTR_HPP_
+
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+#include "gam/Context.hpp"  //ctx
+#include "gam/GlobalPointer.hpp"
+#include "gam/public_ptr.hpp"
+
+namespace gam {
+
+/**
+ * @brief represents an integral value in global memory, updated atomically
+ * in place by any holder.
+ *
+ * Atomic pointers are reference-counted and passed around as public
+ * pointers, but the pointed value is never copied: each operation is applied
+ * where the value lives, either by fabric atomics, if the provider supports
+ * them for T, or by the author.
+ */
+template <typename T>
+class atomic_ptr {
+  static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                "atomic_ptr requires non-boolean integral types");
+
+ public:
+  atomic_ptr() noexcept {}
+
+  /**
+   * @brief atomic pointer constructor.
+   * @ingroup internals
+   *
+   * It wraps a public pointer to an integral value.
+   */
+  explicit atomic_ptr(public_ptr<T> &&p) noexcept : p(std::move(p)) {}
+
+  /*
+   ***************************************************************************
+   *
+   * atomic operations, all sequentially consistent
+   *
+   ***************************************************************************
+   */
+  T load() { return apply(AO_LOAD, T(), T(), "load()"); }
+
+  /**
+   * @retval the value preceding the addition
+   */
+  T fetch_add(T arg) { return apply(AO_FETCH_ADD, arg, T(), "fetch_add()"); }
+
+  /**
+   * @retval the value preceding the swap
+   */
+  T swap(T desired) { return apply(AO_SWAP, desired, T(), "swap()"); }
+
+  /**
+   * @brief stores desired if the value equals expected, as in std::atomic
+   *
+   * @retval whether the value was updated, expected is set to the previous
+   * value otherwise
+   */
+  bool compare_exchange(T &expected, T desired) {
+    T prev = apply(AO_CSWAP, desired, expected, "compare_exchange()");
+    bool res = prev == expected;
+    expected = prev;
+    return res;
+  }
+
+  /**
+   * @ brief non-disruptively transfers an atomic pointer to another executor
+   *
+   * @param to is the executor to transfer to
+   */
+  void push(executor_id to) const { p.push(to); }
+
+  GlobalPointer get() const noexcept { return p.get(); }
+
+  /**
+   * @brief pretty-prints the pointer
+   */
+  friend std::ostream &operator<<(std::ostream &out, const atomic_ptr &f) {
+    return out << "[ATM global=" << f.p.get() << "]";
+  }
+
+  bool operator==(std::nullptr_t) const noexcept { return p == nullptr; }
+
+  bool operator!=(std::nullptr_t) const noexcept { return !(p == nullptr); }
+
+ private:
+  public_ptr<T> p;
+  Context::atomic_route route;  // resolved at first use
+
+  T apply(AtomicOp op, T operand, T compare, const char *name) {
+    if (p.get().is_address())
+      return ctx().atomic_apply(p.get(), op, operand, compare, route);
+    std::cerr << "> called " << name << " for non-address pointer:\n"
+              << p.get() << std::endl;
+    return T();
+  }
+};
+
+/**
+ * @brief creates an atomic value authored by the calling executor
+ */
+template <typename T>
+atomic_ptr<T> make_atomic(T init = T()) {
+  return atomic_ptr<T>(make_public<T>(init));
+}
+
+/**
+ * @ brief blocking pull an incoming atomic pointer from another executor
+ *
+ * @param from is the executor to pull from
+ * @retval the incoming pointer
+ */
+template <typename T>
+atomic_ptr<T> pull_atomic(executor_id from) {
+  return atomic_ptr<T>(pull_public<T>(from));
+}
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_ATOMIC_PTR_HPP_ */
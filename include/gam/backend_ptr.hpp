@@ -19,17 +19,51 @@
  */
 
 /**
- * @brief       a short description of the source file
+ * @brief       implements backend_ptr classes
+ *
+ * @ingroup internals
  *
  */
 #ifndef INCLUDE_GAM_BACKEND_PTR_HPP_
 #define INCLUDE_GAM_BACKEND_PTR_HPP_
 
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
 #include "gam/defs.hpp"
+#include "gam/marshalling.hpp"
 #include "gam/TrackingAllocator.hpp"
+#include "gam/wrapped_allocator.hpp"
 
 namespace gam {
 
+/*
+ * the entries of the object held by a backend: backends of objects marshalled
+ * by traits are always framed, hence never asked for entries
+ */
+template <typename T>
+marshalled_t backend_entries(T &v, std::false_type) {
+  return marshall_entries(v);
+}
+
+template <typename T>
+marshalled_t backend_entries(T &, std::true_type) {
+  std::cerr << "> marshall() called for an object marshalled by traits"
+            << std::endl;
+  std::abort();
+}
+
+template <typename T>
+marshalled_t backend_entries(T &v) {
+  return backend_entries(
+      v, std::integral_constant<bool, marshal_mode_of<T>::value ==
+                                          marshal_mode::traits>{});
+}
+
 /*
  *
  */
@@ -38,7 +72,15 @@ class backend_ptr {
   virtual ~backend_ptr() {}
 
   virtual void *get() const = 0;
+  virtual size_t size() const = 0;
   virtual marshalled_t marshall() const = 0;
+  virtual marshal_mode mode() const = 0;
+  virtual bool framed() const = 0;
+  virtual frame_header pack(frame_buffer &frame) const = 0;
+  virtual void unpack(const char *frame, const frame_header &h) = 0;
+
+  /* the contiguous payload, if any */
+  virtual bool payload(const void *&base, size_t &size) const = 0;
 };
 
 template <typename T, typename Deleter>
@@ -50,16 +92,28 @@ class backend_typed_ptr : public backend_ptr {
 
   void *get() const { return (void *)ptr; }
 
+  size_t size() const { return sizeof(T); }
+
   T *typed_get() const { return ptr; }
 
-  marshalled_t marshall_(std::true_type) const {
-    return marshalled_t(1, {ptr, sizeof(T)});
+  marshalled_t marshall() const { return backend_entries(*ptr); }
+
+  marshal_mode mode() const { return marshal_mode_of<T>::value; }
+
+  bool framed() const { return framed_object<T>::value; }
+
+  frame_header pack(frame_buffer &frame) const {
+    return pack_object(*ptr, frame);
   }
 
-  marshalled_t marshall_(std::false_type) const { return ptr->marshall(); }
+  void unpack(const char *frame, const frame_header &h) {
+    unpack_object(*ptr, frame, h);
+  }
 
-  marshalled_t marshall() const {
-    return marshall_(std::is_trivially_copyable<T>{});
+  bool payload(const void *&base, size_t &size) const {
+    base = contiguous_payload<T>::data(*ptr);
+    size = contiguous_payload<T>::size(*ptr);
+    return contiguous_payload<T>::supported;
   }
 
  private:
@@ -67,6 +121,57 @@ class backend_typed_ptr : public backend_ptr {
   Deleter d;
 };
 
+/*
+ * backend holding the object in place, so that object and backend are
+ * allocated at once.
+ * The object is preceded by an allocation header, as if allocated by
+ * wrapped_allocator, so that children can be linked to their parent.
+ */
+template <typename T>
+class backend_inline_ptr : public backend_ptr {
+  static_assert(alignof(T) <= alignof(alloc_header),
+                "over-aligned types cannot be held in place");
+
+ public:
+  template <typename... Params>
+  explicit backend_inline_ptr(Params... p) {
+    assert((void *)&storage == (void *)(&link + 1));
+    new (&storage) T(p...);
+  }
+
+  ~backend_inline_ptr() { typed_get()->~T(); }
+
+  void *get() const { return (void *)&storage; }
+
+  size_t size() const { return sizeof(T); }
+
+  T *typed_get() const { return (T *)&storage; }
+
+  marshalled_t marshall() const { return backend_entries(*typed_get()); }
+
+  marshal_mode mode() const { return marshal_mode_of<T>::value; }
+
+  bool framed() const { return framed_object<T>::value; }
+
+  frame_header pack(frame_buffer &frame) const {
+    return pack_object(*typed_get(), frame);
+  }
+
+  void unpack(const char *frame, const frame_header &h) {
+    unpack_object(*typed_get(), frame, h);
+  }
+
+  bool payload(const void *&base, size_t &size) const {
+    base = contiguous_payload<T>::data(*typed_get());
+    size = contiguous_payload<T>::size(*typed_get());
+    return contiguous_payload<T>::supported;
+  }
+
+ private:
+  alloc_header link;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
 } /* namespace gam */
 
 #endif /* INCLUDE_GAM_BACKEND_PTR_HPP_ */
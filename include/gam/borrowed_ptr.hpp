@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief implements borrowed_ptr class
+ *
+ */
+
+#ifndef INCLUDE_GAM_BORROWED_PTR_HPP_
+#define INCLUDE_GAM_BORROWED_PTR_HPP_
+
+#include <cstddef>
+#include <utility>
+
+#include "gam/Context.hpp"  //ctx
+#include "gam/GlobalPointer.hpp"
+#include "gam/gam_unique_ptr.hpp"
+
+namespace gam {
+
+/**
+ * @brief represents a read-only view of public memory.
+ *
+ * A borrowed_ptr value is returned by public_ptr::borrow() and represents
+ * either:
+ * - the committed object itself, if authored by the local executor, pinned
+ *   by an extra reference until the borrowed_ptr is destroyed; no memory is
+ *   allocated or copied
+ * - a local copy of the object, if authored remotely
+ *
+ * It is move-only, as std::unique_ptr.
+ */
+template <typename T>
+class borrowed_ptr {
+ public:
+  borrowed_ptr() noexcept {}
+
+  /* view of a pinned, locally-authored object */
+  borrowed_ptr(const T *ptr, const GlobalPointer &pinned) noexcept
+      : ptr(ptr), pinned(pinned) {}
+
+  /* view of a local copy */
+  explicit borrowed_ptr(gam_unique_ptr<T> &&local) noexcept
+      : ptr(local.get()), copy(std::move(local)) {}
+
+  ~borrowed_ptr() { release(); }
+
+  borrowed_ptr(const borrowed_ptr &) = delete;
+  borrowed_ptr &operator=(const borrowed_ptr &) = delete;
+
+  borrowed_ptr(borrowed_ptr &&other) noexcept
+      : ptr(other.ptr), pinned(other.pinned), copy(std::move(other.copy)) {
+    other.ptr = nullptr;
+    other.pinned.address(0);
+  }
+
+  borrowed_ptr &operator=(borrowed_ptr &&other) noexcept {
+    if (this != &other) {
+      release();
+      ptr = other.ptr;
+      pinned = other.pinned;
+      copy = std::move(other.copy);
+      other.ptr = nullptr;
+      other.pinned.address(0);
+    }
+    return *this;
+  }
+
+  const T &operator*() const { return *ptr; }
+
+  const T *operator->() const noexcept { return ptr; }
+
+  const T *get() const noexcept { return ptr; }
+
+  explicit operator bool() const noexcept { return ptr != nullptr; }
+
+  /* true if aliasing the committed object, rather than a copy */
+  bool is_alias() const noexcept { return pinned.is_address(); }
+
+ private:
+  const T *ptr = nullptr;
+  GlobalPointer pinned;  // address of the pinned object, if aliasing
+  gam_unique_ptr<T> copy{nullptr, [](T *) {}};
+
+  void release() {
+    if (pinned.is_address()) {
+      ctx().rc_dec(pinned);
+      pinned.address(0);
+    }
+    copy.reset();
+    ptr = nullptr;
+  }
+};
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_BORROWED_PTR_HPP_ */
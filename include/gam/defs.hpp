@@ -54,6 +54,11 @@ enum AccessLevel { AL_PUBLIC, AL_PRIVATE };
 //    CR_PRODUCER, CR_CONSUMER
 //};
 
+/**
+ * @brief atomic operations on global memory, all returning the previous value
+ */
+enum AtomicOp { AO_LOAD, AO_FETCH_ADD, AO_SWAP, AO_CSWAP };
+
 typedef uint32_t executor_id;
 
 template <typename T>
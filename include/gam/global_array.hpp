@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       implements global_array class and generators
+ *
+ * @ingroup api
+ *
+ */
+#ifndef INCLUDE_GAM_GLOBAL_ARRAY_HPP_
+#define INCLUDE_GAM_GLOBAL_ARRAY_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <type_traits>
+#include <vector>
+
+#include "gam/Context.hpp"  //ctx
+#include "gam/GlobalPointer.hpp"
+#include "gam/active_message.hpp"
+#include "gam/public_ptr.hpp"
+
+namespace gam {
+
+enum Distribution { DIST_BLOCK, DIST_CYCLIC, DIST_BLOCK_CYCLIC };
+
+/**
+ * @brief maps the indexes of a global array to executors.
+ * @ingroup internals
+ *
+ * Indexes are dealt to executors round-robin, by blocks of block elements:
+ * block distribution is a single round of ceil(n / executors) elements,
+ * whereas cyclic distribution deals single elements.
+ * The elements of each executor are stored in global order, so that any
+ * index range is a contiguous range of each partition.
+ */
+struct array_layout {
+  size_t n, executors, block;
+
+  executor_id owner(size_t i) const { return (i / block) % executors; }
+
+  /* the partition index of global index i */
+  size_t local_index(size_t i) const {
+    return i / (block * executors) * block + i % block;
+  }
+
+  /* the global index of index j of the partition of executor q */
+  size_t global_index(executor_id q, size_t j) const {
+    return j / block * block * executors + q * block + j % block;
+  }
+
+  /* the number of elements of executor q below global index i */
+  size_t count_below(executor_id q, size_t i) const {
+    size_t round = block * executors, rem = i % round, first = q * block;
+    size_t tail = rem > first ? std::min(rem - first, block) : 0;
+    return i / round * block + tail;
+  }
+
+  size_t partition_size(executor_id q) const { return count_below(q, n); }
+};
+
+/*
+ * handlers loading and storing a range of a partition, from offset
+ */
+template <typename T>
+std::vector<T> array_get(const std::vector<T> &part, size_t offset,
+                         size_t len) {
+  size_t first = std::min(offset, part.size());
+  size_t last = first + std::min(len, part.size() - first);
+  return std::vector<T>(part.begin() + first, part.begin() + last);
+}
+
+template <typename T>
+size_t array_put(std::vector<T> &part, size_t offset,
+                 const std::vector<T> &values) {
+  size_t res = offset < part.size()
+                   ? std::min(values.size(), part.size() - offset)
+                   : 0;
+  std::copy(values.begin(), values.begin() + res, part.begin() + offset);
+  return res;
+}
+
+/**
+ * @brief represents an array of trivially-copyable elements, partitioned
+ * among all the executors.
+ *
+ * Each partition is a vector authored by its executor, held by public
+ * pointers only for reference counting and routing: it is never loaded as
+ * public memory, but only accessed in place by handlers run by its
+ * executor, one active message per owner and range, so that partitions are
+ * never copied as a whole.
+ * Local access to the partition of the calling executor is serialized with
+ * handlers as well, hence accesses to each element are atomic and applied in
+ * the order the owner serves them; stores are applied when returning.
+ * Arrays are reference-counted and passed around as public pointers.
+ */
+template <typename T>
+class global_array {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "global_array requires trivially-copyable elements");
+
+ public:
+  using partition_type = std::vector<T>;
+
+  global_array() noexcept {}
+
+  /**
+   * @brief global array constructor.
+   * @ingroup internals
+   *
+   * It wraps the layout and one partition per executor, by rank.
+   */
+  global_array(const array_layout &l, public_ptr<array_layout> &&lp,
+               std::vector<public_ptr<partition_type>> &&parts)
+      : l(l), lp(std::move(lp)), parts(std::move(parts)) {}
+
+  size_t size() const noexcept { return l.n; }
+
+  const array_layout &layout() const noexcept { return l; }
+
+  executor_id owner(size_t i) const { return l.owner(i); }
+
+  /*
+   ***************************************************************************
+   *
+   * element and range access
+   *
+   ***************************************************************************
+   */
+  T get(size_t i) const {
+    T res = T();
+    get(i, i + 1, &res);
+    return res;
+  }
+
+  void put(size_t i, const T &v) { put(i, i + 1, &v); }
+
+  /**
+   * @brief loads the elements in [lo, hi) into dst, by one request per
+   * owner
+   *
+   * @retval the number of loaded elements, clipped at the array size
+   */
+  size_t get(size_t lo, size_t hi, T *dst) const {
+    if (!check_range(lo, hi, "get()")) return 0;
+    for (executor_id q = 0; q < l.executors; ++q) {
+      size_t c_lo = l.count_below(q, lo), len = l.count_below(q, hi) - c_lo;
+      if (!len) continue;
+      std::vector<T> values =
+          ctx().invoke<am_handler<GAM_HANDLER(array_get<T>)>>(parts[q].get(),
+                                                              c_lo, len);
+      assert(values.size() == len);
+      for_each_run(q, c_lo, len, [&](size_t j, size_t i, size_t run) {
+        memcpy(dst + (i - lo), values.data() + j, run * sizeof(T));
+      });
+    }
+    return hi - lo;
+  }
+
+  /**
+   * @brief stores the elements in [lo, hi) from src, by one request per
+   * owner
+   *
+   * @retval the number of stored elements, clipped at the array size
+   */
+  size_t put(size_t lo, size_t hi, const T *src) {
+    if (!check_range(lo, hi, "put()")) return 0;
+    std::vector<T> values;
+    for (executor_id q = 0; q < l.executors; ++q) {
+      size_t c_lo = l.count_below(q, lo), len = l.count_below(q, hi) - c_lo;
+      if (!len) continue;
+      values.resize(len);
+      for_each_run(q, c_lo, len, [&](size_t j, size_t i, size_t run) {
+        memcpy(values.data() + j, src + (i - lo), run * sizeof(T));
+      });
+      ctx().invoke<am_handler<GAM_HANDLER(array_put<T>)>>(parts[q].get(), c_lo,
+                                                          values);
+    }
+    return hi - lo;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * local partition
+   *
+   ***************************************************************************
+   */
+  /**
+   * @brief direct access to the partition of the calling executor
+   *
+   * f(data, size) accesses the elements in place, with no request, and maps
+   * them back to global indexes by global_index().
+   * It is serialized with the handlers serving other executors, hence it
+   * must not operate on global memory itself.
+   */
+  template <typename F>
+  void local_partition(F &&f) {
+    if (!check("local_partition()")) return;
+    ctx().apply_local<partition_type>(
+        parts[ctx().rank()].get(),
+        [&](partition_type &part) { f(part.data(), part.size()); });
+  }
+
+  /* the global index of index j of the local partition */
+  size_t global_index(size_t j) const {
+    return l.global_index(ctx().rank(), j);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * passing arrays
+   *
+   ***************************************************************************
+   */
+  /**
+   * @ brief non-disruptively transfers the array to another executor
+   *
+   * @param to is the executor to transfer to
+   */
+  void push(executor_id to) const {
+    lp.push(to);
+    push_batch(to, parts);
+  }
+
+  /**
+   * @brief pretty-prints the array
+   */
+  friend std::ostream &operator<<(std::ostream &out, const global_array &a) {
+    return out << "[ARR n=" << a.l.n << " block=" << a.l.block
+               << " layout=" << a.lp.get() << "]";
+  }
+
+ private:
+  array_layout l{0, 0, 1};
+  public_ptr<array_layout> lp;
+  std::vector<public_ptr<partition_type>> parts;
+
+  bool check(const char *name) const {
+    if (!parts.empty()) return true;
+    std::cerr << "> called " << name << " for empty array" << std::endl;
+    return false;
+  }
+
+  bool check_range(size_t lo, size_t &hi, const char *name) const {
+    hi = std::min(hi, l.n);
+    return check(name) && lo < hi;
+  }
+
+  /* f(j, i, run) for each run of elements contiguous in both spaces */
+  template <typename F>
+  void for_each_run(executor_id q, size_t c_lo, size_t len, F &&f) const {
+    for (size_t j = 0; j < len;) {
+      size_t pj = c_lo + j;
+      size_t run = std::min(l.block - pj % l.block, len - j);
+      f(j, l.global_index(q, pj), run);
+      j += run;
+    }
+  }
+};
+
+/**
+ * @brief creates a global array of n value-initialized elements, with one
+ * partition per executor, authored by its executor
+ *
+ * @param d is the distribution of elements among executors
+ * @param block is the block size for DIST_BLOCK_CYCLIC
+ */
+template <typename T>
+global_array<T> make_global_array(size_t n, Distribution d = DIST_BLOCK,
+                                  size_t block = 1) {
+  array_layout l{n, ctx().cardinality(), 1};
+  switch (d) {
+    case DIST_BLOCK:
+      l.block = std::max((n + l.executors - 1) / l.executors, (size_t)1);
+      break;
+    case DIST_CYCLIC:
+      l.block = 1;
+      break;
+    case DIST_BLOCK_CYCLIC:
+      l.block = std::max(block, (size_t)1);
+      break;
+  }
+
+  std::vector<public_ptr<std::vector<T>>> parts;
+  for (executor_id q = 0; q < l.executors; ++q)
+    parts.push_back(make_public_on<std::vector<T>>(q, l.partition_size(q)));
+  return global_array<T>(l, make_public<array_layout>(l), std::move(parts));
+}
+
+/**
+ * @ brief blocking pull an incoming global array from another executor
+ *
+ * @param from is the executor to pull from
+ * @retval the incoming array
+ */
+template <typename T>
+global_array<T> pull_global_array(executor_id from) {
+  auto lp = pull_public<array_layout>(from);
+  array_layout l{0, 0, 1};
+  if (lp != nullptr) lp.load_into(l);
+  std::vector<public_ptr<std::vector<T>>> parts;
+  while (parts.size() < l.executors) {
+    auto batch =
+        pull_public_batch<std::vector<T>>(from, l.executors - parts.size());
+    for (auto &p : batch) parts.push_back(std::move(p));
+  }
+  return global_array<T>(l, std::move(lp), std::move(parts));
+}
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_GLOBAL_ARRAY_HPP_ */
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       implements global_unordered_map class and generators
+ *
+ * @ingroup api
+ *
+ */
+#ifndef INCLUDE_GAM_GLOBAL_UNORDERED_MAP_HPP_
+#define INCLUDE_GAM_GLOBAL_UNORDERED_MAP_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gam/Context.hpp"  //ctx
+#include "gam/GlobalPointer.hpp"
+#include "gam/active_message.hpp"
+#include "gam/public_ptr.hpp"
+
+namespace gam {
+
+/*
+ ***************************************************************************
+ *
+ * shard handlers, run by the owner of the shard
+ *
+ ***************************************************************************
+ */
+template <typename Shard>
+std::pair<bool, typename Shard::mapped_type> shard_find(
+    const Shard &s, const typename Shard::key_type &k) {
+  auto it = s.find(k);
+  if (it == s.end()) return {false, typename Shard::mapped_type()};
+  return {true, it->second};
+}
+
+template <typename Shard>
+bool shard_insert(Shard &s, const typename Shard::key_type &k,
+                  const typename Shard::mapped_type &v, bool assign) {
+  auto res = s.emplace(k, v);
+  if (!res.second && assign) res.first->second = v;
+  return res.second;
+}
+
+template <typename Shard>
+size_t shard_erase(Shard &s, const typename Shard::key_type &k) {
+  return s.erase(k);
+}
+
+template <typename Shard>
+std::vector<std::pair<bool, typename Shard::mapped_type>> shard_find_batch(
+    const Shard &s, const std::vector<typename Shard::key_type> &keys) {
+  std::vector<std::pair<bool, typename Shard::mapped_type>> res;
+  res.reserve(keys.size());
+  for (auto &k : keys) res.push_back(shard_find(s, k));
+  return res;
+}
+
+template <typename Shard>
+size_t shard_insert_batch(
+    Shard &s,
+    const std::vector<std::pair<typename Shard::key_type,
+                                typename Shard::mapped_type>> &kvs,
+    bool assign) {
+  size_t res = 0;
+  for (auto &kv : kvs) res += shard_insert(s, kv.first, kv.second, assign);
+  return res;
+}
+
+template <typename Shard>
+size_t shard_erase_batch(Shard &s,
+                         const std::vector<typename Shard::key_type> &keys) {
+  size_t res = 0;
+  for (auto &k : keys) res += s.erase(k);
+  return res;
+}
+
+/**
+ * @brief represents an unordered map partitioned among all the executors.
+ *
+ * Keys are hashed to owner executors, each owning a shard of the map, that
+ * is an unordered_map authored by the owner, held by public pointers only
+ * for reference counting and routing.
+ * Lookups and updates are shipped to the owner, which serves them in place
+ * by active messages, one at a time, so that shards are never copied nor
+ * loaded as public memory.
+ * Batched operations are served by one request per owner.
+ * Maps are reference-counted and passed around as public pointers.
+ *
+ * Optionally, values found remotely are kept in a local read cache, with
+ * least-recently-used eviction: cached values are not updated by other
+ * executors, hence the cache suits hot, read-mostly keys.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class global_unordered_map {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using shard_type = std::unordered_map<K, V, Hash>;
+
+  global_unordered_map() noexcept {}
+
+  /**
+   * @brief global unordered map constructor.
+   * @ingroup internals
+   *
+   * It wraps one shard per executor, by rank.
+   */
+  explicit global_unordered_map(std::vector<public_ptr<shard_type>> &&shards)
+      : shards(std::move(shards)) {}
+
+  /*
+   * routing by the mixed hash (i.e., the finalizer of MurmurHash3), so that
+   * the buckets of each shard are not biased by routing
+   */
+  executor_id owner(const K &k) const {
+    uint64_t h = Hash()(k);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % shards.size();
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * single-key operations
+   *
+   ***************************************************************************
+   */
+  /**
+   * @brief looks a key up, from the read cache if enabled
+   *
+   * @retval whether the key was found, v is set to its value if so
+   */
+  bool find(const K &k, V &v) {
+    if (!check("find()")) return false;
+    if (cache.find(k, v)) return true;
+    executor_id q = owner(k);
+    auto res = serve<GAM_HANDLER(shard_find<shard_type>)>(q, k);
+    if (res.first) {
+      v = res.second;
+      if (q != ctx().rank()) cache.insert(k, res.second);
+    }
+    return res.first;
+  }
+
+  size_t count(const K &k) {
+    V v;
+    return find(k, v);
+  }
+
+  /**
+   * @brief inserts a key-value pair, unless the key is already present
+   *
+   * @retval whether the pair was inserted
+   */
+  bool insert(const K &k, const V &v) { return insert(k, v, false); }
+
+  /**
+   * @brief inserts a key-value pair or assigns the value of a present key
+   *
+   * @retval whether the pair was inserted
+   */
+  bool insert_or_assign(const K &k, const V &v) { return insert(k, v, true); }
+
+  /**
+   * @retval the number of erased pairs (i.e., 0 or 1)
+   */
+  size_t erase(const K &k) {
+    if (!check("erase()")) return 0;
+    cache.erase(k);
+    return serve<GAM_HANDLER(shard_erase<shard_type>)>(owner(k), k);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * batched operations, one request per owner
+   *
+   ***************************************************************************
+   */
+  /**
+   * @brief looks keys up, from the read cache if enabled
+   *
+   * @retval for each key, whether it was found and its value if so
+   */
+  std::vector<std::pair<bool, V>> find(const std::vector<K> &keys) {
+    std::vector<std::pair<bool, V>> res(keys.size(), {false, V()});
+    if (!check("find()")) return res;
+
+    std::vector<std::vector<size_t>> by_owner(shards.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+      if (cache.find(keys[i], res[i].second))
+        res[i].first = true;
+      else
+        by_owner[owner(keys[i])].push_back(i);
+
+    std::vector<K> batch;
+    for (executor_id q = 0; q < shards.size(); ++q) {
+      if (by_owner[q].empty()) continue;
+      batch.clear();
+      for (size_t i : by_owner[q]) batch.push_back(keys[i]);
+      auto found = serve<GAM_HANDLER(shard_find_batch<shard_type>)>(q, batch);
+      for (size_t j = 0; j < found.size(); ++j) {
+        size_t i = by_owner[q][j];
+        res[i] = std::move(found[j]);
+        if (res[i].first && q != ctx().rank())
+          cache.insert(keys[i], res[i].second);
+      }
+    }
+    return res;
+  }
+
+  /**
+   * @retval the number of inserted pairs
+   */
+  size_t insert(const std::vector<value_type> &kvs) {
+    return insert(kvs, false);
+  }
+
+  /**
+   * @retval the number of inserted pairs, others being assigned
+   */
+  size_t insert_or_assign(const std::vector<value_type> &kvs) {
+    return insert(kvs, true);
+  }
+
+  /**
+   * @retval the number of erased pairs
+   */
+  size_t erase(const std::vector<K> &keys) {
+    if (!check("erase()")) return 0;
+    std::vector<std::vector<K>> by_owner(shards.size());
+    for (auto &k : keys) {
+      cache.erase(k);
+      by_owner[owner(k)].push_back(k);
+    }
+
+    size_t res = 0;
+    for (executor_id q = 0; q < shards.size(); ++q)
+      if (!by_owner[q].empty())
+        res += serve<GAM_HANDLER(shard_erase_batch<shard_type>)>(
+            q, by_owner[q]);
+    return res;
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * local read cache
+   *
+   ***************************************************************************
+   */
+  /**
+   * @brief enables the read cache, holding up to capacity values
+   *
+   * Disabled by zero capacity.
+   */
+  void cache_capacity(size_t capacity) { cache.resize(capacity); }
+
+  /**
+   * @brief drops all the cached values
+   */
+  void invalidate_cache() { cache.clear(); }
+
+  /*
+   ***************************************************************************
+   *
+   * passing maps
+   *
+   ***************************************************************************
+   */
+  /**
+   * @ brief non-disruptively transfers the map to another executor
+   *
+   * The read cache is not transferred.
+   *
+   * @param to is the executor to transfer to
+   */
+  void push(executor_id to) const { push_batch(to, shards); }
+
+  /**
+   * @brief pretty-prints the map
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const global_unordered_map &m) {
+    out << "[MAP shards=" << m.shards.size();
+    if (!m.shards.empty()) out << " first=" << m.shards[0].get();
+    return out << "]";
+  }
+
+ private:
+  /*
+   * least-recently-used cache of values
+   */
+  class read_cache {
+   public:
+    bool find(const K &k, V &v) {
+      if (!capacity) return false;
+      auto it = index.find(k);
+      if (it == index.end()) return false;
+      lru.splice(lru.begin(), lru, it->second);  // most recently used
+      v = it->second->second;
+      return true;
+    }
+
+    void insert(const K &k, const V &v) {
+      if (!capacity) return;
+      auto it = index.find(k);
+      if (it != index.end()) {
+        it->second->second = v;
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+      }
+      if (index.size() == capacity) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+      }
+      lru.emplace_front(k, v);
+      index.emplace(k, lru.begin());
+    }
+
+    void erase(const K &k) {
+      auto it = index.find(k);
+      if (it == index.end()) return;
+      lru.erase(it->second);
+      index.erase(it);
+    }
+
+    void resize(size_t c) {
+      capacity = c;
+      while (index.size() > capacity) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+      }
+    }
+
+    void clear() {
+      index.clear();
+      lru.clear();
+    }
+
+   private:
+    size_t capacity = 0;
+    std::list<value_type> lru;
+    std::unordered_map<K, typename std::list<value_type>::iterator, Hash>
+        index;
+  };
+
+  std::vector<public_ptr<shard_type>> shards;
+  read_cache cache;
+
+  /*
+   * shards are only accessed by handlers, run by their author under the
+   * active-message lock, hence they are updated in place
+   */
+  template <typename F, F f, typename... Args>
+  typename am_handler<F, f>::result_type serve(executor_id q,
+                                               const Args &... args) {
+    return ctx().invoke<am_handler<F, f>>(shards[q].get(), args...);
+  }
+
+  bool check(const char *name) const {
+    if (!shards.empty()) return true;
+    std::cerr << "> called " << name << " for empty map" << std::endl;
+    return false;
+  }
+
+  bool insert(const K &k, const V &v, bool assign) {
+    if (!check(assign ? "insert_or_assign()" : "insert()")) return false;
+    cache.erase(k);
+    return serve<GAM_HANDLER(shard_insert<shard_type>)>(owner(k), k, v, assign);
+  }
+
+  size_t insert(const std::vector<value_type> &kvs, bool assign) {
+    if (!check(assign ? "insert_or_assign()" : "insert()")) return 0;
+    std::vector<std::vector<value_type>> by_owner(shards.size());
+    for (auto &kv : kvs) {
+      cache.erase(kv.first);
+      by_owner[owner(kv.first)].push_back(kv);
+    }
+
+    size_t res = 0;
+    for (executor_id q = 0; q < shards.size(); ++q)
+      if (!by_owner[q].empty())
+        res += serve<GAM_HANDLER(shard_insert_batch<shard_type>)>(
+            q, by_owner[q], assign);
+    return res;
+  }
+};
+
+/**
+ * @brief creates an empty global unordered map, with one shard per executor,
+ * authored by its executor
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+global_unordered_map<K, V, Hash> make_global_unordered_map() {
+  using shard_type = typename global_unordered_map<K, V, Hash>::shard_type;
+  std::vector<public_ptr<shard_type>> shards;
+  for (executor_id q = 0; q < ctx().cardinality(); ++q)
+    shards.push_back(make_public_on<shard_type>(q));
+  return global_unordered_map<K, V, Hash>(std::move(shards));
+}
+
+/**
+ * @ brief blocking pull an incoming global unordered map from another
+ * executor
+ *
+ * @param from is the executor to pull from
+ * @retval the incoming map
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+global_unordered_map<K, V, Hash> pull_global_unordered_map(executor_id from) {
+  using shard_type = typename global_unordered_map<K, V, Hash>::shard_type;
+  std::vector<public_ptr<shard_type>> shards;
+  if (from >= ctx().cardinality() || from == ctx().rank()) {
+    std::cerr << "> pull_global_unordered_map() towards invalid rank: "
+              << from << std::endl;
+    return global_unordered_map<K, V, Hash>();
+  }
+  while (shards.size() < ctx().cardinality()) {
+    auto batch = pull_public_batch<shard_type>(
+        from, ctx().cardinality() - shards.size());
+    for (auto &p : batch) shards.push_back(std::move(p));
+  }
+  return global_unordered_map<K, V, Hash>(std::move(shards));
+}
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_GLOBAL_UNORDERED_MAP_HPP_ */
@@ -28,12 +28,24 @@
 #ifndef INCLUDE_GAM_LINKS_IMPLEMENTATIONS_FL_COMMON_HPP_
 #define INCLUDE_GAM_LINKS_IMPLEMENTATIONS_FL_COMMON_HPP_
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 #include <rdma/fabric.h>
+#include <rdma/fi_atomic.h>
 #include <rdma/fi_domain.h>
+#include <rdma/fi_endpoint.h>
+#include <rdma/fi_errno.h>
+#include <rdma/fi_rma.h>
+
+#include "gam/RegisteredArena.hpp"
+#include "gam/defs.hpp"
 
 namespace gam {
 
@@ -43,6 +55,9 @@ static struct fi_info *fl_info_;
 static struct fid_fabric *fl_fabric_;
 static struct fid_domain *fl_domain_;
 static const char *fl_node_;
+static uint64_t fl_caps_;  // capabilities requested to the provider
+static uint64_t fl_order_ = FI_ORDER_SAS;  // message ordering, if granted
+static std::atomic<uint64_t> fl_next_key_{1};
 
 static void fl_node(const char *n) { fl_node_ = n; }
 
@@ -55,9 +70,15 @@ static void fl_getinfo(fi_info **fi,                           //
   // prepare for querying fabric contexts
   hints->caps = FI_MSG | caps;
   hints->ep_attr->type = ep_type;
+  hints->tx_attr->msg_order = hints->rx_attr->msg_order = fl_order_;
 
-  // query fabric contexts
+  // query fabric contexts, dropping the ordering if no provider grants it
   ret = fi_getinfo(FL_FI_VERSION, node, service, flags, hints, fi);
+  if (ret && fl_order_) {
+    LOGLN("> no send-after-send ordering, streaming one chunk at a time");
+    fl_order_ = hints->tx_attr->msg_order = hints->rx_attr->msg_order = 0;
+    ret = fi_getinfo(FL_FI_VERSION, node, service, flags, hints, fi);
+  }
   assert(!ret);
 
   for (fi_info *cur = *fi; cur; cur = cur->next) {
@@ -75,6 +96,9 @@ static void fl_getinfo(fi_info **fi,                           //
 
   fi_freeinfo(hints);
 
+  if (!((*fi)->tx_attr->msg_order & (*fi)->rx_attr->msg_order & FI_ORDER_SAS))
+    fl_order_ = 0;
+
   struct fi_info *cur;
   for (cur = *fi; cur; cur = cur->next) {
     LOGLN("provider: %s", cur->fabric_attr->prov_name);
@@ -88,11 +112,47 @@ static void fl_getinfo(fi_info **fi,                           //
   }
 }
 
+/*
+ * check whether some provider supports the given capabilities
+ */
+static bool fl_probe(const char *node, enum fi_ep_type ep_type, uint64_t caps) {
+  fi_info *hints = fi_allocinfo(), *fi = nullptr;
+
+  hints->caps = FI_MSG | caps;
+  hints->ep_attr->type = ep_type;
+  int ret = fi_getinfo(FL_FI_VERSION, node, NULL, 0, hints, &fi);
+
+  if (fi) fi_freeinfo(fi);
+  fi_freeinfo(hints);
+  return !ret;
+}
+
 static int fl_dst_addr(char *node, char *service, struct fi_info **fi_dst,
                        uint64_t flags) {
   return fi_getinfo(FL_FI_VERSION, node, service, flags, fl_info_, fi_dst);
 }
 
+/*
+ * registration of arena regions with the domain, requesting unique keys
+ */
+static bool fl_mr_reg(void *base, size_t len, void **handle, void **desc) {
+  struct fid_mr *mr;
+  uint64_t access = FI_SEND | FI_RECV | FI_READ | FI_WRITE |  //
+                    FI_REMOTE_READ | FI_REMOTE_WRITE;
+  if (fi_mr_reg(fl_domain_, base, len, access, 0, fl_next_key_++, 0, &mr,
+                NULL))
+    return false;
+  *handle = mr;
+  *desc = fi_mr_desc(mr);
+  return true;
+}
+
+static void fl_mr_dereg(void *handle) {
+  int ret = fi_close(&((struct fid_mr *)handle)->fid);
+  assert(!ret);
+  (void)ret;
+}
+
 static void fl_init(fi_info *fi) {
   int ret = 0;
 
@@ -103,11 +163,16 @@ static void fl_init(fi_info *fi) {
   ret += fi_domain(fl_fabric_, fi, &fl_domain_, NULL);
 
   assert(!ret);
+
+  // register local memory
+  RegisteredArena::instance().attach({fl_mr_reg, fl_mr_dereg});
 }
 
 static void fl_fini() {
   int ret = 0;
 
+  RegisteredArena::instance().detach();
+
   ret += fi_close(&fl_domain_->fid);
   ret += fi_close(&fl_fabric_->fid);
   assert(!ret);
@@ -121,10 +186,11 @@ static void fl_fini() {
  ***************************************************************************
  */
 static ssize_t fl_post_rx(fid_ep *ep, void *rxbuf, size_t size,
-                          fi_addr_t from) {
+                          fi_addr_t from, void *context = NULL) {
+  void *desc = RegisteredArena::instance().descriptor(rxbuf);
   int ret;
   while (1) {
-    ret = fi_recv(ep, rxbuf, size, NULL, from, NULL);
+    ret = fi_recv(ep, rxbuf, size, desc, from, context);
     if (!ret) break;
     assert(ret == -FI_EAGAIN);
   }
@@ -134,9 +200,10 @@ static ssize_t fl_post_rx(fid_ep *ep, void *rxbuf, size_t size,
 
 static ssize_t fl_post_tx(fid_ep *ep, const void *txbuf, size_t size,
                           fi_addr_t to) {
+  void *desc = RegisteredArena::instance().descriptor(txbuf);
   int ret;
   while (1) {
-    ret = fi_send(ep, txbuf, size, NULL, to, NULL);
+    ret = fi_send(ep, txbuf, size, desc, to, NULL);
     if (!ret) break;
     assert(ret == -FI_EAGAIN);
   }
@@ -151,6 +218,41 @@ static ssize_t fl_post_tx(fid_ep *ep, const void *txbuf, size_t size,
  *
  ***************************************************************************
  */
+/*
+ * consume and report the error entry of a failed completion read, returning
+ * the error of the failed operation
+ */
+static ssize_t fl_cq_error(struct fid_cq *cq, ssize_t ret) {
+  if (ret != -FI_EAVAIL) {
+    std::cerr << "> fi_cq_read failed: " << fi_strerror((int)-ret) << std::endl;
+    return ret;
+  }
+
+  struct fi_cq_err_entry err;
+  memset(&err, 0, sizeof(err));
+  ret = fi_cq_readerr(cq, &err, 0);
+  if (ret < 0) {
+    std::cerr << "> fi_cq_readerr failed: " << fi_strerror((int)-ret)
+              << std::endl;
+    return ret;
+  }
+
+  std::cerr << "> completion error: " << fi_strerror(err.err) << " ("
+            << fi_cq_strerror(cq, err.prov_errno, err.err_data, NULL, 0)
+            << ")" << std::endl;
+  return err.err ? -err.err : -FI_EAVAIL;
+}
+
+/*
+ * abort on failed blocking transfers, whose buffers are left incomplete
+ */
+static void fl_check(ssize_t ret, const char *name) {
+  if (!ret) return;
+  std::cerr << "> " << name << " failed: " << fi_strerror((int)-ret)
+            << std::endl;
+  std::abort();
+}
+
 // spin-wait some completions on a completion queue
 static int fl_spin_for_comp(struct fid_cq *cq) {
   struct fi_cq_err_entry comp;
@@ -161,7 +263,7 @@ static int fl_spin_for_comp(struct fid_cq *cq) {
     if (ret > 0)
       return 0;
     else if (ret < 0 && ret != -FI_EAGAIN)
-      return ret;
+      return fl_cq_error(cq, ret);
   }
 
   return 0;
@@ -181,6 +283,271 @@ static ssize_t fl_tx(fid_ep *ep, fid_cq *txcq, const void *tx_buf,
   return ret;
 }
 
+/*
+ ***************************************************************************
+ *
+ * support for chunked pipelined streaming
+ *
+ ***************************************************************************
+ */
+/*
+ * Large buffers are streamed as a sequence of chunks, keeping several chunks
+ * in flight, so that messages never exceed the provider limit and the
+ * receiver can process each chunk as soon as it lands.
+ * Chunk boundaries only depend on the buffer size, so that any buffer sent
+ * by fl_stream_tx can be received by fl_stream_rx.
+ * Chunk sends are untagged, thus each one lands into the first matching
+ * receive: several sends are kept in flight only if the provider grants
+ * send-after-send ordering.
+ */
+constexpr size_t fl_stream_chunk = (size_t)1 << 20;  // unless provider-capped
+constexpr unsigned fl_stream_window = 8;             // chunks in flight
+
+static size_t fl_chunk_size() {
+  size_t res = fl_stream_chunk;
+  if (fl_info_ && fl_info_->ep_attr->max_msg_size)
+    res = std::min(res, fl_info_->ep_attr->max_msg_size);
+  return res;
+}
+
+static unsigned fl_msg_window() {
+  return (fl_order_ & FI_ORDER_SAS) ? fl_stream_window : 1;
+}
+
+static ssize_t fl_stream_tx(fid_ep *ep, fid_cq *txcq, const void *tx_buf,
+                            size_t size, fi_addr_t to) {
+  const size_t chunk = fl_chunk_size();
+  const unsigned window = fl_msg_window();
+  const char *p = (const char *)tx_buf;
+  ssize_t ret = 0;
+  unsigned inflight = 0;
+
+  if (!size) return fl_tx(ep, txcq, tx_buf, 0, to);
+
+  for (size_t off = 0; off < size; off += chunk) {
+    if (inflight == window) {
+      ret += fl_spin_for_comp(txcq);
+      --inflight;
+    }
+    ret += fl_post_tx(ep, p + off, std::min(chunk, size - off), to);
+    ++inflight;
+  }
+  while (inflight--) ret += fl_spin_for_comp(txcq);
+
+  return ret;
+}
+
+/*
+ * keep up to window chunk operations in flight, posted by post(off, len, ctx),
+ * calling on_chunk(offset, len) for each chunk in order, as soon as it and
+ * all the previous ones have completed on cq
+ */
+template <typename Post, typename F>
+static ssize_t fl_pipeline(fid_cq *cq, size_t size, unsigned window,
+                           Post &&post, F &&on_chunk) {
+  const size_t chunk = fl_chunk_size();
+  const size_t n = size ? (size + chunk - 1) / chunk : 1;
+  bool landed[fl_stream_window] = {false};
+  size_t posted = 0, delivered = 0;
+  ssize_t ret = 0;
+
+  assert(window && window <= fl_stream_window);
+
+  while (delivered < n) {
+    /* keep the window full, chunk contexts being their 1-based index */
+    for (; posted < n && posted - delivered < window; ++posted) {
+      size_t off = posted * chunk;
+      ret += post(off, std::min(chunk, size - off),
+                  (void *)(uintptr_t)(posted + 1));
+    }
+
+    struct fi_cq_entry comp;
+    ssize_t r = fi_cq_read(cq, &comp, 1);  // non-blocking pop
+    if (r == -FI_EAGAIN) continue;
+    if (r < 0) return fl_cq_error(cq, r);
+
+    size_t i = (uintptr_t)comp.op_context - 1;
+    assert(i >= delivered && i < posted);
+    landed[i % fl_stream_window] = true;
+
+    /* deliver landed chunks in order */
+    while (delivered < posted && landed[delivered % fl_stream_window]) {
+      landed[delivered % fl_stream_window] = false;
+      size_t off = delivered * chunk;
+      if (size) on_chunk(off, std::min(chunk, size - off));
+      ++delivered;
+    }
+  }
+
+  return ret;
+}
+
+/*
+ * receive a stream, calling on_chunk(offset, len) for each chunk in order,
+ * as soon as it and all the previous ones have landed
+ */
+template <typename F>
+static ssize_t fl_stream_rx(fid_ep *ep, fid_cq *rxcq, void *rx_buf,
+                            size_t size, fi_addr_t from, F &&on_chunk) {
+  char *p = (char *)rx_buf;
+  return fl_pipeline(rxcq, size, fl_msg_window(),
+                     [&](size_t off, size_t len, void *ctx) {
+                       return fl_post_rx(ep, p + off, len, from, ctx);
+                     },
+                     on_chunk);
+}
+
+/*
+ ***************************************************************************
+ *
+ * support for rendezvous transfers
+ *
+ ***************************************************************************
+ */
+/*
+ * Eager transfers above fl_rndv_threshold are likely to land as unexpected
+ * messages, that the provider buffers and copies once more.
+ * Instead, the sender exposes the payload for remote reads and the receiver
+ * reads it straight into the destination buffer, once the latter is known.
+ */
+constexpr size_t fl_rndv_threshold = (size_t)1 << 16;
+
+struct fl_rma_window {
+  uint64_t addr;  // virtual address or region offset, by MR mode
+  uint64_t key;
+};
+
+static bool fl_rendezvous(size_t size) {
+  return (fl_caps_ & FI_RMA) && size >= fl_rndv_threshold;
+}
+
+static bool fl_mr_virt_addr() {
+  int mode = fl_info_->domain_attr->mr_mode;
+#ifdef FI_MR_VIRT_ADDR
+  if (mode & FI_MR_VIRT_ADDR) return true;
+#endif
+  return mode == FI_MR_BASIC;
+}
+
+/*
+ * expose [p, p+size) for remote reads, registering it on demand unless it
+ * is in a registered arena region; handle is set to on-demand registrations,
+ * to be released by fl_unexpose
+ */
+static bool fl_expose(const void *p, size_t size, fl_rma_window &w,
+                      void *&handle) {
+  void *mr, *desc;
+  const char *base;
+  handle = nullptr;
+  if (!RegisteredArena::instance().registration(p, mr, base)) {
+    if (!fl_mr_reg(const_cast<void *>(p), size, &mr, &desc)) return false;
+    base = (const char *)p;
+    handle = mr;
+  }
+  w.key = fi_mr_key((struct fid_mr *)mr);
+  w.addr = fl_mr_virt_addr() ? (uint64_t)(uintptr_t)p
+                             : (uint64_t)((const char *)p - base);
+  return true;
+}
+
+static void fl_unexpose(void *handle) {
+  if (handle) fl_mr_dereg(handle);
+}
+
+/*
+ * read size bytes exposed by a peer as pipelined chunks, calling
+ * on_chunk(offset, len) for each chunk in order
+ */
+template <typename F>
+static ssize_t fl_stream_read(fid_ep *ep, fid_cq *txcq, void *dst,
+                              size_t size, fi_addr_t from,
+                              const fl_rma_window &w, F &&on_chunk) {
+  char *p = (char *)dst;
+  void *handle = nullptr, *desc = RegisteredArena::instance().descriptor(dst);
+  if (!desc) fl_mr_reg(dst, size, &handle, &desc);  // best effort
+
+  ssize_t ret = fl_pipeline(
+      txcq, size, fl_stream_window,
+      [&](size_t off, size_t len, void *ctx) {
+        ssize_t r;
+        while ((r = fi_read(ep, p + off, len, desc, from, w.addr + off, w.key,
+                            ctx)) == -FI_EAGAIN)
+          ;
+        return r;
+      },
+      on_chunk);
+
+  fl_unexpose(handle);
+  return ret;
+}
+
+/*
+ ***************************************************************************
+ *
+ * support for fabric atomics
+ *
+ ***************************************************************************
+ */
+static enum fi_datatype fl_datatype(size_t size, bool is_signed) {
+  switch (size) {
+    case 1:
+      return is_signed ? FI_INT8 : FI_UINT8;
+    case 2:
+      return is_signed ? FI_INT16 : FI_UINT16;
+    case 4:
+      return is_signed ? FI_INT32 : FI_UINT32;
+    default:
+      assert(size == 8);
+      return is_signed ? FI_INT64 : FI_UINT64;
+  }
+}
+
+/*
+ * Fabric atomics are not atomic with respect to CPU atomics, so either all
+ * the operations on a datatype are supported by the provider or none is used.
+ */
+static bool fl_atomic_valid(fid_ep *ep, enum fi_datatype dt) {
+  size_t count;
+  return (fl_caps_ & FI_ATOMIC) &&
+         !fi_fetch_atomicvalid(ep, dt, FI_ATOMIC_READ, &count) &&
+         !fi_fetch_atomicvalid(ep, dt, FI_SUM, &count) &&
+         !fi_fetch_atomicvalid(ep, dt, FI_ATOMIC_WRITE, &count) &&
+         !fi_compare_atomicvalid(ep, dt, FI_CSWAP, &count);
+}
+
+/*
+ * apply an atomic operation to a single element exposed by a peer, storing
+ * the previous value into result
+ */
+static ssize_t fl_atomic(fid_ep *ep, fid_cq *txcq, AtomicOp op,
+                         enum fi_datatype dt, const void *operand,
+                         const void *compare, void *result, fi_addr_t to,
+                         const fl_rma_window &w) {
+  RegisteredArena &arena = RegisteredArena::instance();
+  void *desc = arena.descriptor(operand), *res_desc = arena.descriptor(result);
+  ssize_t ret;
+  do {
+    switch (op) {
+      case AO_CSWAP:
+        ret = fi_compare_atomic(ep, operand, 1, desc, compare,
+                                arena.descriptor(compare), result, res_desc,
+                                to, w.addr, w.key, dt, FI_CSWAP, NULL);
+        break;
+      default:
+        ret = fi_fetch_atomic(ep, operand, 1, desc, result, res_desc, to,
+                              w.addr, w.key, dt,
+                              op == AO_LOAD ? FI_ATOMIC_READ
+                                            : op == AO_SWAP ? FI_ATOMIC_WRITE
+                                                            : FI_SUM,
+                              NULL);
+        break;
+    }
+  } while (ret == -FI_EAGAIN);
+  if (ret) return ret;
+
+  return fl_spin_for_comp(txcq);
+}
+
 } /* namespace gam */
 
 #endif /* INCLUDE_GAM_LINKS_IMPLEMENTATIONS_FL_COMMON_HPP_ */
@@ -65,7 +65,17 @@ class fl_connectionless {
     // query fabric contexts
     LOGLN("LKS init_links");
     uint64_t flags = 0;
-    fl_getinfo(&fl_info_, src_node, NULL, flags, FI_EP_RDM, FI_DIRECTED_RECV);
+    const uint64_t rma = FI_RMA | FI_READ | FI_REMOTE_READ;
+    const uint64_t atomics = FI_ATOMIC | FI_WRITE | FI_REMOTE_WRITE;
+    fl_caps_ = FI_DIRECTED_RECV;
+    if (fl_probe(src_node, FI_EP_RDM, fl_caps_ | rma | atomics))
+      fl_caps_ |= rma | atomics;
+    else if (fl_probe(src_node, FI_EP_RDM, fl_caps_ | rma)) {
+      fl_caps_ |= rma;
+      LOGLN("LKS no atomics support, falling back to daemon atomics");
+    } else
+      LOGLN("LKS no RMA support, rendezvous disabled");
+    fl_getinfo(&fl_info_, src_node, NULL, flags, FI_EP_RDM, fl_caps_);
 
     fl_init(fl_info_);
 
@@ -148,14 +158,22 @@ class fl_connectionless {
     assert(!ret);
   }
 
+  /*
+   * directed transfers are streamed, see fl_stream_tx
+   */
   void raw_send(const void *p, const size_t size, const executor_id to) {
-    ssize_t ret = fl_tx(ep_, txcq, p, size, rank_to_addr[to]);
-    assert(!ret);
+    fl_check(fl_stream_tx(ep_, txcq, p, size, rank_to_addr[to]), "raw_send()");
   }
 
   void raw_recv(void *p, const size_t size, const executor_id from) {
-    ssize_t ret = rx(p, size, rank_to_addr[from]);
-    assert(!ret);
+    stream_recv(p, size, from, [](size_t, size_t) {});
+  }
+
+  template <typename F>
+  void stream_recv(void *p, const size_t size, const executor_id from,
+                   F &&on_chunk) {
+    fl_check(fl_stream_rx(ep_, rxcq, p, size, rank_to_addr[from], on_chunk),
+             "stream_recv()");
   }
 
   void raw_recv(void *p, const size_t size) {
@@ -163,6 +181,50 @@ class fl_connectionless {
     assert(!ret);
   }
 
+  /*
+   ***************************************************************************
+   *
+   * rendezvous transfers, see fl_rndv_threshold
+   *
+   ***************************************************************************
+   */
+  using rma_window = fl_rma_window;
+
+  static bool rendezvous(const size_t size) { return fl_rendezvous(size); }
+
+  static bool expose(const void *p, const size_t size, rma_window &w,
+                     void *&handle) {
+    return fl_expose(p, size, w, handle);
+  }
+
+  static void unexpose(void *handle) { fl_unexpose(handle); }
+
+  /*
+   * whether fabric atomics apply to integral values of the given size
+   */
+  bool atomic_valid(const size_t size, const bool is_signed) {
+    return fl_atomic_valid(ep_, fl_datatype(size, is_signed));
+  }
+
+  void atomic(AtomicOp op, const size_t size, const bool is_signed,
+              const void *operand, const void *compare, void *result,
+              const executor_id to, const rma_window &w) {
+    ssize_t ret = fl_atomic(ep_, txcq, op, fl_datatype(size, is_signed),
+                            operand, compare, result, rank_to_addr[to], w);
+    assert(!ret);
+  }
+
+  /*
+   * read a buffer exposed by the peer (i.e., by its receive link)
+   */
+  template <typename F>
+  void rma_read(void *p, const size_t size, const executor_id from,
+                const rma_window &w, F &&on_chunk) {
+    fl_check(
+        fl_stream_read(ep_, txcq, p, size, rank_to_addr[from], w, on_chunk),
+        "rma_read()");
+  }
+
   /*
    ***************************************************************************
    *
@@ -199,7 +261,7 @@ class fl_connectionless {
     // get fabric context
     LOGLN("LKS src-endpoint node=%s svc=%s", node, service);
     fi_info *fi;
-    fl_getinfo(&fi, node, service, FI_SOURCE, FI_EP_RDM, FI_DIRECTED_RECV);
+    fl_getinfo(&fi, node, service, FI_SOURCE, FI_EP_RDM, fl_caps_);
 
     struct fi_cq_attr cq_attr;
 
@@ -29,6 +29,7 @@
 #define INCLUDE_GAM_LINKS_STUB_HPP_
 
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 
 #include <rdma/fabric.h>
@@ -90,6 +91,73 @@ class links_stub {
 
   void raw_recv(void *p, const size_t size) { internals.raw_recv(p, size); }
 
+  /*
+   * receive, calling on_chunk(offset, len) as chunks land, in order
+   */
+  template <typename F>
+  void stream_recv(void *p, const size_t size, const executor_id from,
+                   F &&on_chunk) {
+    internals.stream_recv(p, size, from, on_chunk);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * rendezvous transfers
+   *
+   ***************************************************************************
+   */
+  using rma_window = typename impl::rma_window;
+
+  /*
+   * whether a payload of the given size should be moved by rendezvous
+   */
+  static bool rendezvous(const size_t size) { return impl::rendezvous(size); }
+
+  /*
+   * expose a buffer for remote reads, until unexposed by handle
+   */
+  static bool expose(const void *p, const size_t size, rma_window &w,
+                     void *&handle) {
+    return impl::expose(p, size, w, handle);
+  }
+
+  static void unexpose(void *handle) { impl::unexpose(handle); }
+
+  /*
+   * read a buffer exposed by a peer, calling on_chunk(offset, len) in order
+   */
+  template <typename F>
+  void rma_read(void *p, const size_t size, const executor_id from,
+                const rma_window &w, F &&on_chunk) {
+    internals.rma_read(p, size, from, w, on_chunk);
+  }
+
+  /*
+   ***************************************************************************
+   *
+   * fabric atomics on single integral values
+   *
+   ***************************************************************************
+   */
+  template <typename V>
+  bool atomic_valid() {
+    static_assert(std::is_integral<V>::value, "atomics on integral values");
+    return internals.atomic_valid(sizeof(V), std::is_signed<V>::value);
+  }
+
+  /*
+   * apply op to the value exposed by a peer, returning the previous value
+   */
+  template <typename V>
+  V atomic(AtomicOp op, const V &operand, const V &compare,
+           const executor_id to, const rma_window &w) {
+    V res;
+    internals.atomic(op, sizeof(V), std::is_signed<V>::value, &operand,
+                     &compare, &res, to, w);
+    return res;
+  }
+
   void send(const T &p, const executor_id to) { raw_send(&p, sizeof(T), to); }
 
   void recv(T &p, const executor_id from) { raw_recv(&p, sizeof(T), from); }
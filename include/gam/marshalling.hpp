@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       marshalling of non-trivially-copyable types
+ *
+ * @ingroup internals
+ *
+ * A non-trivially-copyable type T is transferred by the marshall()/ingest()
+ * protocol: the author sends each entry returned by T::marshall(), whereas
+ * the receiver calls T::ingest(f), where f(dst, size) receives the next entry
+ * into dst.
+ * By default each entry is a separate message, thus the receiver blocks on
+ * each entry before deciding the next one.
+ *
+ * Types can opt in framed marshalling by specializing framed_marshalling:
+ * the author packs all the entries into a single frame, with a length table,
+ * and sends it preceded by a fixed-size header.
+ * The receiver posts one receive, sized by the header, and ingests the
+ * object from memory.
+ *
+ * Types with no marshall()/ingest() members are marshalled by marshal_traits,
+ * if supported: standard strings and containers (vector, array, pair, tuple,
+ * map, unordered_map), nested at will, are supported out of the box.
+ * Such objects are always framed: the traits write a byte stream into the
+ * frame, contiguous trivially-copyable payloads being copied as single
+ * blocks.
+ * Users can support further types by specializing marshal_traits.
+ */
+#ifndef INCLUDE_GAM_MARSHALLING_HPP_
+#define INCLUDE_GAM_MARSHALLING_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gam/defs.hpp"
+#include "gam/wrapped_allocator.hpp"
+
+namespace gam {
+
+template <typename T>
+struct framed_marshalling : std::false_type {};
+
+/* frame buffers are drawn from registered memory */
+using frame_buffer = std::vector<char, wrapped_allocator::std_allocator<char>>;
+
+/*
+ * a frame is the length table (one uint64_t per entry) followed by the
+ * payload of the entries
+ */
+struct frame_header {
+  uint64_t n_entries;
+  uint64_t size;  // frame size in bytes, length table included
+};
+
+/*
+ ***************************************************************************
+ *
+ * marshall()/ingest() entries
+ *
+ ***************************************************************************
+ */
+
+/*
+ * pack marshalled entries into a frame
+ */
+template <typename Buffer>
+frame_header pack_frame(const marshalled_t &entries, Buffer &frame) {
+  frame_header res;
+  res.n_entries = entries.size();
+  res.size = res.n_entries * sizeof(uint64_t);
+  for (auto &me : entries) res.size += me.size;
+
+  frame.clear();
+  frame.reserve(res.size);
+  for (auto &me : entries) {
+    uint64_t len = me.size;
+    const char *l = (const char *)&len;
+    frame.insert(frame.end(), l, l + sizeof(uint64_t));
+  }
+  for (auto &me : entries) {
+    const char *b = (const char *)me.base;
+    frame.insert(frame.end(), b, b + me.size);
+  }
+  assert(frame.size() == res.size);
+
+  return res;
+}
+
+/*
+ * feed ingest() from a received frame, checking that entries are consumed
+ * as they were marshalled
+ */
+class frame_reader {
+ public:
+  frame_reader(const char *frame, const frame_header &h)
+      : lengths(frame),
+        payload(frame + h.n_entries * sizeof(uint64_t)),
+        n_entries(h.n_entries) {}
+
+  void operator()(void *dst, size_t size) {
+    assert(next < n_entries);
+    uint64_t len;
+    memcpy(&len, lengths + next * sizeof(uint64_t), sizeof(uint64_t));
+    assert(len == size);
+    (void)len;
+    memcpy(dst, payload, size);
+    payload += size;
+    ++next;
+  }
+
+  bool done() const { return next == n_entries; }
+
+ private:
+  const char *lengths, *payload;
+  uint64_t n_entries, next = 0;
+};
+
+/*
+ ***************************************************************************
+ *
+ * byte streams, for marshal_traits
+ *
+ ***************************************************************************
+ */
+template <typename Buffer>
+class stream_writer {
+ public:
+  explicit stream_writer(Buffer &frame) : frame(frame) { frame.clear(); }
+
+  void write(const void *src, size_t size) {
+    const char *b = (const char *)src;
+    frame.insert(frame.end(), b, b + size);
+  }
+
+  /* a stream frame has no length table */
+  frame_header finish() const { return frame_header{0, frame.size()}; }
+
+ private:
+  Buffer &frame;
+};
+
+class stream_reader {
+ public:
+  stream_reader(const char *frame, const frame_header &h)
+      : cur(frame), end(frame + h.size) {
+    assert(!h.n_entries);
+  }
+
+  void read(void *dst, size_t size) {
+    assert(size <= (size_t)(end - cur));
+    memcpy(dst, cur, size);
+    cur += size;
+  }
+
+  bool done() const { return cur == end; }
+
+ private:
+  const char *cur, *end;
+};
+
+/*
+ ***************************************************************************
+ *
+ * marshalling traits
+ *
+ ***************************************************************************
+ */
+/**
+ * Specializations provide:
+ * - static constexpr bool supported = true
+ * - template <typename Writer> static void marshall(const T &, Writer &w),
+ *   calling w.write(src, size)
+ * - template <typename Reader> static void ingest(T &, Reader &r),
+ *   calling r.read(dst, size) in the same sequence; the object is either
+ *   default-constructed or a previously loaded one, to be overwritten
+ */
+template <typename T, typename Enable = void>
+struct marshal_traits {
+  static constexpr bool supported = false;
+};
+
+/* trivially-copyable types, as a single block */
+template <typename T>
+struct marshal_traits<
+    T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+  static constexpr bool supported = true;
+
+  template <typename Writer>
+  static void marshall(const T &v, Writer &w) {
+    w.write(&v, sizeof(T));
+  }
+
+  template <typename Reader>
+  static void ingest(T &v, Reader &r) {
+    r.read(&v, sizeof(T));
+  }
+};
+
+/*
+ * sequences of n elements from first, as a single block if trivially
+ * copyable
+ */
+template <typename T, typename Writer>
+void marshall_sequence(const T *first, size_t n, Writer &w, std::true_type) {
+  if (n) w.write(first, n * sizeof(T));
+}
+
+template <typename T, typename Writer>
+void marshall_sequence(const T *first, size_t n, Writer &w, std::false_type) {
+  for (size_t i = 0; i < n; ++i) marshal_traits<T>::marshall(first[i], w);
+}
+
+template <typename T, typename Reader>
+void ingest_sequence(T *first, size_t n, Reader &r, std::true_type) {
+  if (n) r.read(first, n * sizeof(T));
+}
+
+template <typename T, typename Reader>
+void ingest_sequence(T *first, size_t n, Reader &r, std::false_type) {
+  for (size_t i = 0; i < n; ++i) marshal_traits<T>::ingest(first[i], r);
+}
+
+template <typename C, typename Tr, typename A>
+struct marshal_traits<std::basic_string<C, Tr, A>> {
+  static constexpr bool supported = true;
+
+  template <typename Writer>
+  static void marshall(const std::basic_string<C, Tr, A> &v, Writer &w) {
+    uint64_t n = v.size();
+    w.write(&n, sizeof(uint64_t));
+    if (n) w.write(v.data(), n * sizeof(C));
+  }
+
+  template <typename Reader>
+  static void ingest(std::basic_string<C, Tr, A> &v, Reader &r) {
+    uint64_t n;
+    r.read(&n, sizeof(uint64_t));
+    v.resize(n);
+    if (n) r.read(&v[0], n * sizeof(C));
+  }
+};
+
+template <typename T, typename A>
+struct marshal_traits<std::vector<T, A>> {
+  static constexpr bool supported = marshal_traits<T>::supported;
+
+  template <typename Writer>
+  static void marshall(const std::vector<T, A> &v, Writer &w) {
+    uint64_t n = v.size();
+    w.write(&n, sizeof(uint64_t));
+    marshall_sequence(v.data(), v.size(), w, std::is_trivially_copyable<T>{});
+  }
+
+  template <typename Reader>
+  static void ingest(std::vector<T, A> &v, Reader &r) {
+    uint64_t n;
+    r.read(&n, sizeof(uint64_t));
+    v.resize(n);
+    ingest_sequence(v.data(), v.size(), r, std::is_trivially_copyable<T>{});
+  }
+};
+
+/* vector<bool> is not contiguous, one byte per element */
+template <typename A>
+struct marshal_traits<std::vector<bool, A>> {
+  static constexpr bool supported = true;
+
+  template <typename Writer>
+  static void marshall(const std::vector<bool, A> &v, Writer &w) {
+    uint64_t n = v.size();
+    w.write(&n, sizeof(uint64_t));
+    for (bool b : v) {
+      char c = b;
+      w.write(&c, 1);
+    }
+  }
+
+  template <typename Reader>
+  static void ingest(std::vector<bool, A> &v, Reader &r) {
+    uint64_t n;
+    r.read(&n, sizeof(uint64_t));
+    v.resize(n);
+    for (uint64_t i = 0; i < n; ++i) {
+      char c;
+      r.read(&c, 1);
+      v[i] = c;
+    }
+  }
+};
+
+/* arrays of trivially-copyable types are trivially copyable themselves */
+template <typename T, size_t N>
+struct marshal_traits<
+    std::array<T, N>,
+    typename std::enable_if<!std::is_trivially_copyable<T>::value>::type> {
+  static constexpr bool supported = marshal_traits<T>::supported;
+
+  template <typename Writer>
+  static void marshall(const std::array<T, N> &v, Writer &w) {
+    for (auto &e : v) marshal_traits<T>::marshall(e, w);
+  }
+
+  template <typename Reader>
+  static void ingest(std::array<T, N> &v, Reader &r) {
+    for (auto &e : v) marshal_traits<T>::ingest(e, r);
+  }
+};
+
+template <typename T1, typename T2>
+struct marshal_traits<
+    std::pair<T1, T2>,
+    typename std::enable_if<
+        !std::is_trivially_copyable<std::pair<T1, T2>>::value>::type> {
+  static constexpr bool supported =
+      marshal_traits<T1>::supported && marshal_traits<T2>::supported;
+
+  template <typename Writer>
+  static void marshall(const std::pair<T1, T2> &v, Writer &w) {
+    marshal_traits<T1>::marshall(v.first, w);
+    marshal_traits<T2>::marshall(v.second, w);
+  }
+
+  template <typename Reader>
+  static void ingest(std::pair<T1, T2> &v, Reader &r) {
+    marshal_traits<T1>::ingest(v.first, r);
+    marshal_traits<T2>::ingest(v.second, r);
+  }
+};
+
+template <size_t I, typename... Ts>
+struct tuple_marshaller {
+  using elem_t = typename std::tuple_element<I - 1, std::tuple<Ts...>>::type;
+
+  static constexpr bool supported = tuple_marshaller<I - 1, Ts...>::supported &&
+                                    marshal_traits<elem_t>::supported;
+
+  template <typename Writer>
+  static void marshall(const std::tuple<Ts...> &v, Writer &w) {
+    tuple_marshaller<I - 1, Ts...>::marshall(v, w);
+    marshal_traits<elem_t>::marshall(std::get<I - 1>(v), w);
+  }
+
+  template <typename Reader>
+  static void ingest(std::tuple<Ts...> &v, Reader &r) {
+    tuple_marshaller<I - 1, Ts...>::ingest(v, r);
+    marshal_traits<elem_t>::ingest(std::get<I - 1>(v), r);
+  }
+};
+
+template <typename... Ts>
+struct tuple_marshaller<0, Ts...> {
+  static constexpr bool supported = true;
+
+  template <typename Writer>
+  static void marshall(const std::tuple<Ts...> &, Writer &) {}
+
+  template <typename Reader>
+  static void ingest(std::tuple<Ts...> &, Reader &) {}
+};
+
+template <typename... Ts>
+struct marshal_traits<
+    std::tuple<Ts...>,
+    typename std::enable_if<
+        !std::is_trivially_copyable<std::tuple<Ts...>>::value>::type>
+    : tuple_marshaller<sizeof...(Ts), Ts...> {};
+
+/*
+ * associative containers, as a sequence of key-value pairs
+ */
+template <typename Map>
+struct map_marshaller {
+  using key_type = typename Map::key_type;
+  using mapped_type = typename Map::mapped_type;
+
+  static constexpr bool supported = marshal_traits<key_type>::supported &&
+                                    marshal_traits<mapped_type>::supported;
+
+  template <typename Writer>
+  static void marshall(const Map &v, Writer &w) {
+    uint64_t n = v.size();
+    w.write(&n, sizeof(uint64_t));
+    for (auto &kv : v) {
+      marshal_traits<key_type>::marshall(kv.first, w);
+      marshal_traits<mapped_type>::marshall(kv.second, w);
+    }
+  }
+
+  template <typename Reader>
+  static void ingest(Map &v, Reader &r) {
+    uint64_t n;
+    r.read(&n, sizeof(uint64_t));
+    v.clear();
+    reserve(v, n);
+    for (uint64_t i = 0; i < n; ++i) {
+      key_type k;
+      mapped_type m;
+      marshal_traits<key_type>::ingest(k, r);
+      marshal_traits<mapped_type>::ingest(m, r);
+      v.emplace_hint(v.end(), std::move(k), std::move(m));
+    }
+  }
+
+ private:
+  template <typename M>
+  static auto reserve(M &v, uint64_t n) -> decltype(v.reserve(n), void()) {
+    v.reserve(n);
+  }
+
+  static void reserve(...) {}
+};
+
+template <typename K, typename V, typename C, typename A>
+struct marshal_traits<std::map<K, V, C, A>>
+    : map_marshaller<std::map<K, V, C, A>> {};
+
+template <typename K, typename V, typename H, typename E, typename A>
+struct marshal_traits<std::unordered_map<K, V, H, E, A>>
+    : map_marshaller<std::unordered_map<K, V, H, E, A>> {};
+
+/*
+ ***************************************************************************
+ *
+ * contiguous payloads, for sub-range loads
+ *
+ ***************************************************************************
+ */
+/**
+ * The contiguous payload of an object is the byte range served by sub-range
+ * loads: the object itself, if trivially copyable, or the elements of
+ * strings and vectors of trivially-copyable elements.
+ */
+template <typename T, typename Enable = void>
+struct contiguous_payload {
+  static constexpr bool supported = false;
+  static const void *data(const T &) { return nullptr; }
+  static size_t size(const T &) { return 0; }
+};
+
+template <typename T>
+struct contiguous_payload<
+    T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+  static constexpr bool supported = true;
+  static const void *data(const T &v) { return &v; }
+  static size_t size(const T &) { return sizeof(T); }
+};
+
+template <typename T, typename A>
+struct contiguous_payload<
+    std::vector<T, A>,
+    typename std::enable_if<std::is_trivially_copyable<T>::value &&
+                            !std::is_same<T, bool>::value>::type> {
+  static constexpr bool supported = true;
+  static const void *data(const std::vector<T, A> &v) { return v.data(); }
+  static size_t size(const std::vector<T, A> &v) {
+    return v.size() * sizeof(T);
+  }
+};
+
+template <typename C, typename Tr, typename A>
+struct contiguous_payload<std::basic_string<C, Tr, A>> {
+  static constexpr bool supported = true;
+  static const void *data(const std::basic_string<C, Tr, A> &v) {
+    return v.data();
+  }
+  static size_t size(const std::basic_string<C, Tr, A> &v) {
+    return v.size() * sizeof(C);
+  }
+};
+
+/*
+ * the reply to a sub-range load, preceding the served bytes
+ */
+struct range_header {
+  uint64_t payload_size;  // zero if no contiguous payload
+  uint64_t served;        // bytes following the header
+};
+
+/*
+ * serve [offset, offset + len) of a payload, clipped at its end
+ */
+inline range_header serve_range(size_t payload_size, size_t offset,
+                                size_t len) {
+  range_header res{payload_size, 0};
+  if (offset < payload_size) res.served = std::min(len, payload_size - offset);
+  return res;
+}
+
+/*
+ ***************************************************************************
+ *
+ * dispatching
+ *
+ ***************************************************************************
+ */
+/*
+ * trivially-copyable types are copied, types supported by marshal_traits
+ * are marshalled by traits, other types by their marshall()/ingest()
+ */
+enum class marshal_mode { copy, traits, entries };
+
+template <marshal_mode m>
+using marshal_tag = std::integral_constant<marshal_mode, m>;
+
+template <typename T>
+struct marshal_mode_of
+    : marshal_tag<std::is_trivially_copyable<T>::value
+                      ? marshal_mode::copy
+                      : marshal_traits<T>::supported ? marshal_mode::traits
+                                                     : marshal_mode::entries> {
+};
+
+/*
+ * whether objects of type T are transferred as a single frame
+ */
+template <typename T>
+struct framed_object
+    : std::integral_constant<
+          bool, marshal_mode_of<T>::value == marshal_mode::traits ||
+                    (marshal_mode_of<T>::value == marshal_mode::entries &&
+                     framed_marshalling<T>::value)> {};
+
+template <typename T>
+marshalled_t marshall_entries(T &v, marshal_tag<marshal_mode::copy>) {
+  return marshalled_t(1, {&v, sizeof(T)});
+}
+
+template <typename T>
+marshalled_t marshall_entries(T &v, marshal_tag<marshal_mode::entries>) {
+  return v.marshall();
+}
+
+/*
+ * the entries of an object, to be sent one message each; objects marshalled
+ * by traits have no entries, being always framed
+ */
+template <typename T>
+marshalled_t marshall_entries(T &v) {
+  return marshall_entries(v, marshal_mode_of<T>{});
+}
+
+template <typename T, typename Buffer>
+frame_header pack_object(T &v, Buffer &frame, std::true_type) {
+  stream_writer<Buffer> w(frame);
+  marshal_traits<T>::marshall(v, w);
+  return w.finish();
+}
+
+template <typename T, typename Buffer>
+frame_header pack_object(T &v, Buffer &frame, std::false_type) {
+  return pack_frame(marshall_entries(v), frame);
+}
+
+/*
+ * pack an object into a frame
+ */
+template <typename T, typename Buffer>
+frame_header pack_object(T &v, Buffer &frame) {
+  return pack_object(
+      v, frame,
+      std::integral_constant<bool, marshal_mode_of<T>::value ==
+                                       marshal_mode::traits>{});
+}
+
+template <typename T>
+void unpack_object(T &v, const char *frame, const frame_header &h,
+                   marshal_tag<marshal_mode::copy>) {
+  frame_reader r(frame, h);
+  r(&v, sizeof(T));
+  assert(r.done());
+}
+
+template <typename T>
+void unpack_object(T &v, const char *frame, const frame_header &h,
+                   marshal_tag<marshal_mode::traits>) {
+  stream_reader r(frame, h);
+  marshal_traits<T>::ingest(v, r);
+  assert(r.done());
+}
+
+template <typename T>
+void unpack_object(T &v, const char *frame, const frame_header &h,
+                   marshal_tag<marshal_mode::entries>) {
+  frame_reader r(frame, h);
+  v.ingest([&](void *dst, size_t size) { r(dst, size); });
+  assert(r.done());
+}
+
+/*
+ * ingest an object from a received frame
+ */
+template <typename T>
+void unpack_object(T &v, const char *frame, const frame_header &h) {
+  unpack_object(v, frame, h, marshal_mode_of<T>{});
+}
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_MARSHALLING_HPP_ */
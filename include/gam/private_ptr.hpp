@@ -82,8 +82,8 @@ class private_ptr {
     if (lup != nullptr) {
       LOGLN_OS("PVT constructor unique=" << lp);
 
-      /* lookup parent global pointer */
-      if (!ctx().has_parent(lp)) {
+      /* children are recognized by their deleter */
+      if (!is_child(lup)) {
         // not a private child
         if (!make(lp, lup.get_deleter())) {
           std::cerr
@@ -178,18 +178,14 @@ class private_ptr {
    */
   gam_unique_ptr<T> local() {
     if (internal_gp.is_address() && ctx().am_owner(internal_gp)) {
-      T *lp = ctx().local_private<T>(internal_gp);
+      bool linked;
+      T *lp = ctx().local_private<T>(internal_gp, linked);
 
       /* neutralize parent destruction */
       release();
 
-      /* prepare child deleter */
-      auto deleter = [](T *lp) {
-        assert(ctx().has_parent(lp));
-        ctx().unmap(ctx().parent(lp));
-      };
-
-      return gam_unique_ptr<T>(lp, deleter);
+      return gam_unique_ptr<T>(
+          lp, linked ? delete_linked_child : delete_adopted_child);
     }
 
     if (!internal_gp.is_address()) {
@@ -203,6 +199,72 @@ class private_ptr {
     return gam_unique_ptr<T>(nullptr, [](T *) {});
   }
 
+  /**
+   * @brief writes a value through to the pointed memory
+   *
+   * Unlike local(), the pointer is preserved and no object is migrated:
+   * remotely authored memory is updated in place by its author.
+   *
+   * @param v the value to store
+   */
+  void store(const T &v) {
+    if (internal_gp.is_address() && ctx().am_owner(internal_gp))
+      ctx().store_private(internal_gp, v);
+    else
+      std::cerr << "> called store() for non-owned pointer:\n"
+                << internal_gp << std::endl;
+  }
+
+  /**
+   * @brief writes bytes through to a sub-range of the contiguous payload
+   *
+   * The payload is the object itself, if trivially copyable, or the elements
+   * of a string or of a vector of trivially-copyable elements.
+   * The payload is never resized.
+   *
+   * @param offset the payload offset to store at
+   * @param len the number of bytes to store
+   * @param src the bytes to store
+   * @retval the number of stored bytes, clipped at the end of the payload
+   */
+  size_t store(size_t offset, size_t len, const void *src) {
+    static_assert(contiguous_payload<T>::supported,
+                  "range stores require a contiguous payload");
+    if (internal_gp.is_address() && ctx().am_owner(internal_gp))
+      return ctx().store_private_range(internal_gp, offset, len, src);
+    std::cerr << "> called store() for non-owned pointer:\n"
+              << internal_gp << std::endl;
+    return 0;
+  }
+
+  /**
+   * @brief runs a handler on the pointed memory, where it lives
+   *
+   * The handler is run in place by the author of the pointed memory and
+   * only the arguments and the result are transferred, e.g.:
+   *
+   *   long n = p.invoke<GAM_HANDLER(count_in)>(lo, hi);
+   *
+   * Handlers taking the object by non-const reference update it in place,
+   * in order with the other operations of the owner.
+   * Handlers are serialized per author; handlers with no result are not
+   * waited for.
+   *
+   * @param args the arguments following the object
+   * @retval the handler result
+   */
+  template <typename F, F f, typename... Args>
+  typename am_handler<F, f>::result_type invoke(const Args &... args) const {
+    static_assert(
+        std::is_same<typename am_handler<F, f>::object_type, T>::value,
+        "the handler does not apply to the pointed type");
+    if (internal_gp.is_address() && ctx().am_owner(internal_gp))
+      return ctx().invoke<am_handler<F, f>>(internal_gp, args...);
+    std::cerr << "> called invoke() for non-owned pointer:\n"
+              << internal_gp << std::endl;
+    return typename am_handler<F, f>::result_type();
+  }
+
   /**
    * @ brief disruptively transfers a private pointer to another executor
    *
@@ -305,21 +367,68 @@ class private_ptr {
     LOGLN_OS("PVT writeback unique=" << child.get());
 
     _Tp *lp = child.get();
+    bool linked = child.get_deleter() == delete_linked_child;
 
-    if (ctx().has_parent(lp) && ctx().am_owner(ctx().parent(lp))) {
-      internal_gp = ctx().parent(lp);
+    if (ctx().has_parent(lp, linked) &&
+        ctx().am_owner(ctx().parent(lp, linked))) {
+      internal_gp = ctx().parent(lp, linked);
       return true;
     }
 
     return false;
   }
+
+  /*
+   * child deleters, unmapping the parent
+   */
+  static void delete_linked_child(T *lp) {
+    assert(ctx().has_parent(lp, true));
+    ctx().unmap(ctx().parent(lp, true));
+  }
+
+  static void delete_adopted_child(T *lp) {
+    assert(ctx().has_parent(lp, false));
+    ctx().unmap(ctx().parent(lp, false));
+  }
+
+  static bool is_child(const gam_unique_ptr<T> &lup) {
+    return lup.get_deleter() == delete_linked_child ||
+           lup.get_deleter() == delete_adopted_child;
+  }
 };
 
 template <typename _Tp, typename... _Args>
 private_ptr<_Tp> make_private(_Args &&... __args) {
-  return private_ptr<_Tp>(                       //
-      NEW<_Tp>(std::forward<_Args>(__args)...),  //
-      DELETE<_Tp>);
+  /* object and backend in a single allocation */
+  return private_ptr<_Tp>(
+      ctx().mmap_private_new<_Tp>(std::forward<_Args>(__args)...));
+}
+
+/**
+ * @brief constructs a private object in place on another executor
+ *
+ * The object is authored by the target executor and owned by the caller,
+ * as if pushed by the target, so that no data is moved until local().
+ * Arguments must be trivially copyable and free of local pointers.
+ *
+ * @param rank is the executor to construct on
+ * @retval the private pointer, or nullptr on failure
+ */
+template <typename _Tp, typename... _Args>
+private_ptr<_Tp> make_private_on(executor_id rank, _Args &&... __args) {
+  if (rank == ctx().rank())
+    return make_private<_Tp>(std::forward<_Args>(__args)...);
+  if (rank >= ctx().cardinality()) {
+    std::cerr << "> make_private_on() towards invalid rank: " << rank
+              << std::endl;
+    return nullptr;
+  }
+  GlobalPointer p =
+      ctx().mmap_private_on<_Tp>(rank, std::forward<_Args>(__args)...);
+  if (!p.is_address())
+    std::cerr << "> could not create a private pointer on rank: " << rank
+              << std::endl;
+  return private_ptr<_Tp>(p);
 }
 
 /**
@@ -346,6 +455,66 @@ private_ptr<T> pull_private() noexcept {
   return private_ptr<T>(ctx().pull_private());
 }
 
+/**
+ * @ brief disruptively transfers a batch of private pointers to another
+ * executor
+ *
+ * Pointers are packed into as few messages as possible.
+ * Non-owned pointers are skipped and left untouched.
+ *
+ * @param to is the executor to transfer to
+ * @param ps points to the first pointer of the batch
+ * @param n is the batch length
+ */
+template <typename T>
+void push_batch(executor_id to, private_ptr<T> *ps, size_t n) {
+  if (to != ctx().rank() && to < ctx().cardinality()) {
+    std::vector<GlobalPointer> gps;
+    gps.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      GlobalPointer gp = ps[i].get();
+      if (gp.is_address() && !ctx().am_owner(gp)) {
+        std::cerr << "> called push_batch() for non-owned pointer:\n" << gp
+                  << std::endl;
+        continue;
+      }
+      gps.push_back(gp);
+      ps[i].release();
+    }
+
+    ctx().push_private_batch(gps.data(), gps.size(), to);
+  } else
+    std::cerr << "> called push_batch() towards invalid rank: " << to
+              << std::endl;
+}
+
+template <typename T>
+void push_batch(executor_id to, std::vector<private_ptr<T>> &ps) {
+  push_batch(to, ps.data(), ps.size());
+}
+
+/**
+ * @ brief blocking pull a batch of private pointers from another executor
+ *
+ * It blocks until at least one pointer is available.
+ *
+ * @param from is the executor to pull from
+ * @param max is the maximum number of pointers to return
+ * @retval the incoming pointers
+ */
+template <typename T>
+std::vector<private_ptr<T>> pull_private_batch(executor_id from, size_t max) {
+  std::vector<private_ptr<T>> res;
+  if (from != ctx().rank() && from < ctx().cardinality()) {
+    auto gps = ctx().pull_private_batch(from, max);
+    res.reserve(gps.size());
+    for (auto &gp : gps) res.emplace_back(gp);
+  } else
+    std::cerr << "> pull_private_batch() towards invalid rank: " << from
+              << std::endl;
+  return res;
+}
+
 } /* namespace gam */
 
 #endif /* INCLUDE_GAM_PRIVATE_PTR_HPP_ */
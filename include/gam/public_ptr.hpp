@@ -33,6 +33,7 @@
 #include "gam/Context.hpp"  //ctx
 #include "gam/GlobalPointer.hpp"
 #include "gam/Logger.hpp"
+#include "gam/borrowed_ptr.hpp"
 #include "gam/gam_unique_ptr.hpp"
 #include "gam/private_ptr.hpp"
 
@@ -227,6 +228,153 @@ class public_ptr {
     return gam_unique_ptr<T>(nullptr, [](T *){});
   }
 
+  /**
+   * @brief returns a read-only view of the pointed memory
+   *
+   * If the pointed memory is authored by the calling executor, the view
+   * aliases it, with no allocation or copy, and pins it until the view is
+   * destroyed.
+   * Otherwise, the view holds a local copy, as unique_local().
+   */
+  borrowed_ptr<T> borrow() const {
+    if (internal_gp.is_address()) {
+      const T *lp = ctx().borrow_public<T>(internal_gp);
+      if (lp) return borrowed_ptr<T>(lp, internal_gp);
+      return borrowed_ptr<T>(ctx().unique_local_public<T>(internal_gp));
+    }
+    std::cerr << "> called borrow() for non-address pointer:\n"
+              << internal_gp << std::endl;
+    return borrowed_ptr<T>();
+  }
+
+  /**
+   * @brief loads the pointed memory into a caller-provided object
+   *
+   * No local memory is allocated: trivially-copyable objects are received
+   * straight into dst, whereas other objects are ingested into dst, that is
+   * overwritten.
+   * Hence, reusable buffers can be loaded with no allocation or extra copy.
+   */
+  void load_into(T &dst) const {
+    if (internal_gp.is_address())
+      ctx().load_public<T>(internal_gp, dst);
+    else
+      std::cerr << "> called load_into() for non-address pointer:\n"
+                << internal_gp << std::endl;
+  }
+
+  /**
+   * @brief loads the pointed memory into a caller-provided buffer
+   *
+   * It is only available for trivially-copyable types.
+   *
+   * @param dst is the buffer, with no alignment requirement
+   * @param size is the buffer size, at least sizeof(T)
+   * @retval the number of loaded bytes, zero on error
+   */
+  size_t load_into(void *dst, size_t size) const {
+    if (!internal_gp.is_address()) {
+      std::cerr << "> called load_into() for non-address pointer:\n"
+                << internal_gp << std::endl;
+      return 0;
+    }
+    if (size < sizeof(T)) {
+      std::cerr << "> called load_into() with short buffer: " << size
+                << std::endl;
+      return 0;
+    }
+    ctx().load_public_raw<T>(internal_gp, dst);
+    return sizeof(T);
+  }
+
+  /**
+   * @brief loads a byte range of the pointed memory into a caller-provided
+   * buffer
+   *
+   * Only the requested range is transferred.
+   * The range is relative to the contiguous payload of the pointed object:
+   * the object itself, if trivially copyable, or the elements of a string or
+   * a vector of trivially-copyable elements.
+   * For instance, a public std::vector<double> acts as a public array, from
+   * which each consumer loads its own slice.
+   *
+   * @param offset is the first byte of the range
+   * @param len is the range length
+   * @param dst is the buffer, at least len bytes long
+   * @retval the number of loaded bytes, clipped at the end of the payload
+   */
+  size_t load_range(size_t offset, size_t len, void *dst) const {
+    return load_range(offset, len, dst, [](size_t, size_t) {});
+  }
+
+  /**
+   * @brief streams a byte range of the pointed memory into a caller-provided
+   * buffer
+   *
+   * As load_range, but large ranges are transferred as a pipeline of chunks
+   * and on_chunk(offset, len) is called, in order, as soon as each chunk of
+   * dst is loaded, so that processing can start before the whole range has
+   * landed.
+   */
+  template <typename F>
+  size_t load_range(size_t offset, size_t len, void *dst, F &&on_chunk) const {
+    static_assert(contiguous_payload<T>::supported,
+                  "sub-range loads require a contiguous payload");
+    if (internal_gp.is_address()) {
+      size_t payload_size;
+      return ctx().load_public_range(internal_gp, offset, len, dst,
+                                     payload_size, on_chunk);
+    }
+    std::cerr << "> called load_range() for non-address pointer:\n"
+              << internal_gp << std::endl;
+    return 0;
+  }
+
+  /**
+   * @brief returns the size in bytes of the contiguous payload of the
+   * pointed memory (see load_range)
+   */
+  size_t payload_size() const {
+    static_assert(contiguous_payload<T>::supported,
+                  "sub-range loads require a contiguous payload");
+    size_t res = 0;
+    if (internal_gp.is_address())
+      ctx().load_public_range(internal_gp, 0, 0, nullptr, res);
+    else
+      std::cerr << "> called payload_size() for non-address pointer:\n"
+                << internal_gp << std::endl;
+    return res;
+  }
+
+  /**
+   * @brief runs a handler on the pointed memory, where it lives
+   *
+   * The handler is run in place by the author of the pointed memory and
+   * only the arguments and the result are transferred, e.g.:
+   *
+   *   long n = p.invoke<GAM_HANDLER(count_in)>(lo, hi);
+   *
+   * Handlers take the object by const reference, as public memory is read
+   * by its holders with no synchronization with handlers.
+   * Handlers with no result are not waited for.
+   *
+   * @param args the arguments following the object
+   * @retval the handler result
+   */
+  template <typename F, F f, typename... Args>
+  typename am_handler<F, f>::result_type invoke(const Args &... args) const {
+    static_assert(
+        std::is_same<typename am_handler<F, f>::object_type, T>::value,
+        "the handler does not apply to the pointed type");
+    static_assert(!am_handler<F, f>::mutating,
+                  "handlers on public memory take it by const reference");
+    if (internal_gp.is_address())
+      return ctx().invoke<am_handler<F, f>>(internal_gp, args...);
+    std::cerr << "> called invoke() for non-address pointer:\n"
+              << internal_gp << std::endl;
+    return typename am_handler<F, f>::result_type();
+  }
+
   /**
    * @ brief pushes the pointer to another executor
    *
@@ -309,9 +457,41 @@ class public_ptr {
 
 template <typename _Tp, typename... _Args>
 public_ptr<_Tp> make_public(_Args &&... __args) {
-  return public_ptr<_Tp>(                        //
-      NEW<_Tp>(std::forward<_Args>(__args)...),  //
-      DELETE<_Tp>);
+  /* object and backend in a single allocation */
+  GlobalPointer p =
+      ctx().mmap_public_new<_Tp>(std::forward<_Args>(__args)...);
+  if (p.is_address())
+    ctx().rc_init(p);
+  else
+    std::cerr << "> could not create a public pointer" << std::endl;
+  return public_ptr<_Tp>(p);
+}
+
+/**
+ * @brief constructs a public object in place on another executor
+ *
+ * The object is authored by the target executor, so that no data is moved
+ * until loaded.
+ * Arguments must be trivially copyable and free of local pointers.
+ *
+ * @param rank is the executor to construct on
+ * @retval the public pointer, or nullptr on failure
+ */
+template <typename _Tp, typename... _Args>
+public_ptr<_Tp> make_public_on(executor_id rank, _Args &&... __args) {
+  if (rank == ctx().rank())
+    return make_public<_Tp>(std::forward<_Args>(__args)...);
+  if (rank >= ctx().cardinality()) {
+    std::cerr << "> make_public_on() towards invalid rank: " << rank
+              << std::endl;
+    return nullptr;
+  }
+  GlobalPointer p =
+      ctx().mmap_public_on<_Tp>(rank, std::forward<_Args>(__args)...);
+  if (!p.is_address())
+    std::cerr << "> could not create a public pointer on rank: " << rank
+              << std::endl;
+  return public_ptr<_Tp>(p);
 }
 
 /**
@@ -338,6 +518,57 @@ public_ptr<T> pull_public() noexcept {
   return public_ptr<T>(ctx().pull_public());
 }
 
+/**
+ * @ brief pushes a batch of public pointers to another executor
+ *
+ * Pointers are packed into as few messages as possible and reference counters
+ * are incremented with at most one request per author.
+ *
+ * @param to is the executor to push to
+ * @param ps points to the first pointer of the batch
+ * @param n is the batch length
+ */
+template <typename T>
+void push_batch(executor_id to, const public_ptr<T> *ps, size_t n) {
+  if (to < ctx().cardinality()) {
+    std::vector<GlobalPointer> gps;
+    gps.reserve(n);
+    for (size_t i = 0; i < n; ++i) gps.push_back(ps[i].get());
+
+    ctx().push_public_batch(gps.data(), n, to);
+    ctx().rc_inc_batch(gps.data(), n);
+  } else
+    std::cerr << "> called push_batch() towards invalid rank: " << to
+              << std::endl;
+}
+
+template <typename T>
+void push_batch(executor_id to, const std::vector<public_ptr<T>> &ps) {
+  push_batch(to, ps.data(), ps.size());
+}
+
+/**
+ * @ brief blocking pull a batch of public pointers from another executor
+ *
+ * It blocks until at least one pointer is available.
+ *
+ * @param from is the executor to pull from
+ * @param max is the maximum number of pointers to return
+ * @retval the incoming pointers
+ */
+template <typename T>
+std::vector<public_ptr<T>> pull_public_batch(executor_id from, size_t max) {
+  std::vector<public_ptr<T>> res;
+  if (from < ctx().cardinality() && from != ctx().rank()) {
+    auto gps = ctx().pull_public_batch(from, max);
+    res.reserve(gps.size());
+    for (auto &gp : gps) res.emplace_back(gp);
+  } else
+    std::cerr << "> pull_public_batch() towards invalid rank: " << from
+              << std::endl;
+  return res;
+}
+
 } /* namespace gam */
 
 #endif /* INCLUDE_GAM_PUBLIC_PTR_HPP_ */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief       registry of functions invoked on behalf of remote executors
+ *
+ * @ingroup internals
+ *
+ * Functions are registered at static initialization time, keyed by a hash of
+ * the signature of the registering template instance.
+ * Executors run the same program, so they agree on keys without exchanging
+ * function addresses, which differ across processes.
+ *
+ * Arguments travel as an arg_pack, that is a trivially-copyable aggregate of
+ * shippable values: trivially-copyable and meaningful on any executor (i.e.,
+ * no local pointers).
+ */
+#ifndef INCLUDE_GAM_REGISTRY_HPP_
+#define INCLUDE_GAM_REGISTRY_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+namespace gam {
+
+/*
+ * FNV-1a hash of a string
+ */
+static inline uint64_t signature_hash(const char *s) {
+  uint64_t res = 14695981039346656037ULL;
+  for (; *s; ++s) res = (res ^ (unsigned char)*s) * 1099511628211ULL;
+  return res;
+}
+
+/*
+ * a key unique to each instance of Tag
+ */
+template <typename Tag>
+uint64_t signature_key() {
+  static const uint64_t res = signature_hash(__PRETTY_FUNCTION__);
+  return res;
+}
+
+template <typename F>
+class registry {
+ public:
+  static uint64_t add(uint64_t key, F f) {
+    auto res = table().emplace(key, f);
+    assert(res.second || res.first->second == f);  // no collisions
+    (void)res;
+    return key;
+  }
+
+  static F find(uint64_t key) {
+    auto it = table().find(key);
+    return it != table().end() ? it->second : nullptr;
+  }
+
+ private:
+  static std::unordered_map<uint64_t, F> &table() {
+    static std::unordered_map<uint64_t, F> res;
+    return res;
+  }
+};
+
+/*
+ ***************************************************************************
+ *
+ * argument packs
+ *
+ ***************************************************************************
+ */
+template <typename... Args>
+struct all_shippable : std::true_type {};
+
+template <typename A, typename... Args>
+struct all_shippable<A, Args...>
+    : std::integral_constant<bool, std::is_trivially_copyable<A>::value &&
+                                       !std::is_pointer<A>::value &&
+                                       all_shippable<Args...>::value> {};
+
+template <typename... Args>
+struct arg_pack {};
+
+template <typename A, typename... Args>
+struct arg_pack<A, Args...> {
+  A head;
+  arg_pack<Args...> tail;
+};
+
+static inline arg_pack<> make_arg_pack() { return arg_pack<>{}; }
+
+template <typename A, typename... Args>
+arg_pack<A, Args...> make_arg_pack(const A &a, const Args &... args) {
+  return arg_pack<A, Args...>{a, make_arg_pack(args...)};
+}
+
+/*
+ * call f with the unpacked arguments
+ */
+template <typename F, typename... Done>
+auto apply_pack(F &&f, const arg_pack<> &, const Done &... done)
+    -> decltype(f(done...)) {
+  return f(done...);
+}
+
+template <typename F, typename A, typename... Args, typename... Done>
+auto apply_pack(F &&f, const arg_pack<A, Args...> &p, const Done &... done)
+    -> decltype(apply_pack(f, p.tail, done..., p.head)) {
+  return apply_pack(f, p.tail, done..., p.head);
+}
+
+} /* namespace gam */
+
+#endif /* INCLUDE_GAM_REGISTRY_HPP_ */
@@ -27,58 +27,166 @@
 #ifndef INCLUDE_GAM_WRAPPED_ALLOCATOR_HPP_
 #define INCLUDE_GAM_WRAPPED_ALLOCATOR_HPP_
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <new>
 
+#include "gam/Accounting.hpp"
+#include "gam/SlabAllocator.hpp"
 #include "gam/TrackingAllocator.hpp"
 
 namespace gam {
 
+/*
+ * header prepended to each allocation, keeping the blocks aligned as if
+ * returned by malloc.
+ * It links private children to their parent global address, with no lookup,
+ * records the size class (or the order, for large blocks) the block was
+ * drawn from and the accounting information for the block.
+ */
+struct alignas(alignof(std::max_align_t)) alloc_header {
+  static constexpr uint16_t no_author = 0xffff;
+
+  uint64_t parent = 0;
+  uint8_t size_class = SlabAllocator::large_class;
+  uint8_t large_order = 0;
+  uint16_t type = TypeRegistry::untyped;  // accounting type slot
+  uint16_t author = no_author;            // author, for copies of public data
+
+  /* the memory taken by the block, header included */
+  size_t footprint() const {
+    return size_class == SlabAllocator::large_class
+               ? (size_t)1 << large_order
+               : SlabAllocator::block_size(size_class);
+  }
+};
+
+/*
+ * Outside GAM_DBG, small blocks are served by the SlabAllocator and large
+ * ones by the RegisteredArena, so that all the blocks live in memory
+ * registered with the network.
+ * In any case, blocks are accounted by type.
+ */
 class wrapped_allocator {
  public:
   /*
    * shortcuts
    */
-  inline void *malloc(size_t size) {
+  inline void *malloc(size_t size, unsigned type = TypeRegistry::untyped) {
+    size_t len = sizeof(alloc_header) + size;
+    unsigned c = SlabAllocator::size_class(len), order = 0;
 #ifdef GAM_DBG
-    return a.malloc(size);
+    void *raw = a.malloc(len);
+    if (c == SlabAllocator::large_class)
+      order = RegisteredArena::large_order(len);
 #else
-    return ::malloc(size);
+    void *raw = c == SlabAllocator::large_class
+                    ? arena.allocate_large(len, order)
+                    : slabs.allocate(c);
 #endif
+    if (!raw) throw std::bad_alloc();
+    alloc_header *h = new (raw) alloc_header();
+    h->size_class = (uint8_t)c;
+    h->large_order = (uint8_t)order;
+    h->type = (uint16_t)type;
+    accounting.alloc(type, h->footprint());
+    return h + 1;
   }
 
   inline void free(void *ptr) {
+    alloc_header *h = header(ptr);
+    accounting.free(h->type, h->footprint());
+    if (h->author != alloc_header::no_author)
+      accounting.free_copy(h->author, h->footprint());
 #ifdef GAM_DBG
-    a.free(ptr);
+    a.free(h);
 #else
-    ::free(ptr);
+    if (h->size_class == SlabAllocator::large_class)
+      arena.deallocate_large(h, h->large_order);
+    else
+      slabs.deallocate(h, h->size_class);
 #endif
   }
 
+  /*
+   * account a block as a local copy of public data from author
+   */
+  inline void tag_copy(void *ptr, executor_id author) {
+    alloc_header *h = header(ptr);
+    assert(h->author == alloc_header::no_author);
+    h->author = (uint16_t)author;
+    accounting.copy(author, h->footprint());
+  }
+
   template <typename obj_t, typename... Params>
   inline obj_t *new_(Params... p) {
+    obj_t *ptr = (obj_t *)this->malloc(sizeof(obj_t), type_slot<obj_t>());
 #ifdef GAM_DBG
-    obj_t *ptr = (obj_t *)this->malloc(sizeof(obj_t));
-    a.new_(ptr);
-    return new (ptr) obj_t(p...);
-#else
-    return new obj_t(p...);
+    a.new_(header(ptr));
 #endif
+    return new (ptr) obj_t(p...);
   }
 
   template <typename T>
   inline void delete_(T *ptr) {
-#ifdef GAM_DBG
     ptr->~T();
-    a.delete_(ptr);
-    this->free(ptr);
-#else
-    delete (ptr);
+#ifdef GAM_DBG
+    a.delete_(header(ptr));
 #endif
+    this->free(ptr);
+  }
+
+  /*
+   * the header of a block returned by either malloc or new_
+   */
+  static inline alloc_header *header(void *ptr) {
+    return (alloc_header *)ptr - 1;
+  }
+
+  /**
+   * standard allocator drawing from a wrapped_allocator, for library-side
+   * helper objects (e.g., shared_ptr control blocks)
+   */
+  template <typename T>
+  struct std_allocator {
+    typedef T value_type;
+
+    explicit std_allocator(wrapped_allocator &wa) : wa(&wa) {}
+
+    template <typename U>
+    std_allocator(const std_allocator<U> &o) : wa(o.wa) {}
+
+    T *allocate(size_t n) { return (T *)wa->malloc(n * sizeof(T)); }
+
+    void deallocate(T *p, size_t) { wa->free(p); }
+
+    template <typename U>
+    bool operator==(const std_allocator<U> &o) const {
+      return wa == o.wa;
+    }
+
+    template <typename U>
+    bool operator!=(const std_allocator<U> &o) const {
+      return wa != o.wa;
+    }
+
+    wrapped_allocator *wa;
+  };
+
+  template <typename T>
+  std_allocator<T> std_allocator_for() {
+    return std_allocator<T>(*this);
   }
 
  private:
+  Accounting &accounting = Accounting::instance();
 #ifdef GAM_DBG
   TrackingAllocator a;
+#else
+  SlabAllocator &slabs = SlabAllocator::instance();
+  RegisteredArena &arena = RegisteredArena::instance();
 #endif
 };
 
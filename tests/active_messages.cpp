@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       2-executor network running handlers where the data lives
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gam.hpp"
+
+/*
+ *******************************************************************************
+ *
+ * handlers
+ *
+ *******************************************************************************
+ */
+long count_in(const std::vector<int> &v, int lo, int hi) {
+  long res = 0;
+  for (int x : v) res += (x >= lo && x < hi);
+  return res;
+}
+
+std::vector<std::string> labels(const std::vector<int> &v, std::string tag) {
+  std::vector<std::string> res;
+  for (int x : v) res.push_back(tag + std::to_string(x));
+  return res;
+}
+
+void append(std::vector<int> &v, std::vector<int> tail) {
+  v.insert(v.end(), tail.begin(), tail.end());
+}
+
+size_t concat(std::string &s, std::string tail) {
+  s += tail;
+  return s.size();
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  /* public object authored by 1 */
+  auto v = gam::pull_public<std::vector<int>>(1);
+  long n = v.invoke<GAM_HANDLER(count_in)>(10, 20);
+  assert(n == 10);
+
+  auto l = v.invoke<GAM_HANDLER(labels)>(std::string("x"));
+  assert(l.size() == 100 && l[0] == "x0" && l[99] == "x99");
+
+  /* private objects authored by 1, updated in place */
+  auto s = gam::make_private_on<std::string>(1, (size_t)6, 'r');
+  size_t len = s.invoke<GAM_HANDLER(concat)>(std::string(" string"));
+  assert(len == 13);
+  assert(*s.local() == "rrrrrr string");
+
+  /* updates are not waited for, but served in order */
+  auto pv = gam::make_private_on<std::vector<int>>(1, (size_t)10, 12);
+  pv.invoke<GAM_HANDLER(append)>(std::vector<int>(5, 15));
+  n = pv.invoke<GAM_HANDLER(count_in)>(10, 20);
+  assert(n == 15);
+
+  /* locally-authored object */
+  auto lv = gam::make_public<std::vector<int>>(std::vector<int>{1, 12, 19});
+  n = lv.invoke<GAM_HANDLER(count_in)>(10, 20);
+  assert(n == 2);
+
+  (void)n;
+  (void)len;
+  std::cout << "active messages ok" << std::endl;
+}
+
+void r1() {
+  std::vector<int> v;
+  for (int i = 0; i < 100; ++i) v.push_back(i);
+  gam::make_public<std::vector<int>>(std::move(v)).push(0);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
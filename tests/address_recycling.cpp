@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network checking recycling of global addresses
+ *
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+
+#include "gam.hpp"
+
+typedef int val_t;
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+/*
+ * a hot allocate/release loop never reissues an address: the recycled
+ * offset is retired at the last generation rather than wrapped
+ */
+void hot_loop() {
+  const uint64_t cycles = 2 * (gam::GlobalPointer::max_generation + 1);
+  std::unordered_map<uint64_t, uint64_t> last_generation;
+  gam::GlobalPointer first;
+  bool retired = false;
+  for (uint64_t i = 0; i < cycles; ++i) {
+    auto p = gam::make_private<val_t>(0);
+    gam::GlobalPointer g = p.get();
+    if (!i) first = g;
+    auto it = last_generation.find(g.offset());
+    assert(it == last_generation.end() || g.generation() > it->second);
+    last_generation[g.offset()] = g.generation();
+    if (g.offset() != first.offset() &&
+        last_generation[first.offset()] == gam::GlobalPointer::max_generation)
+      retired = true;
+    (void)it;
+  }
+  assert(retired);
+  (void)retired;
+}
+
+void r0() {
+  hot_loop();
+
+  /* a released address is recycled with a bumped generation */
+  gam::GlobalPointer a;
+  {
+    auto p = gam::make_private<val_t>(1);
+    a = p.get();
+    assert(a.home() == 0);
+  }
+  auto q = gam::make_private<val_t>(2);
+  assert(q.get().offset() == a.offset());
+  assert(q.get().generation() == a.generation() + 1);
+  assert(!(q.get() == a));
+
+  /* migrate a private pointer to 1 */
+  q.push(1);
+
+  /* get it back, re-addressed at its new author */
+  auto r = gam::pull_private<val_t>(1);
+  assert(r.get().home() == 1);
+  assert(*r.local() == 3);
+}
+
+void r1() {
+  auto p = gam::pull_private<val_t>(0);
+  assert(p.get().home() == 0);
+
+  /* taking it local moves authorship (and home) here */
+  auto lp = p.local();
+  assert(*lp == 2);
+  *lp = 3;
+  gam::private_ptr<val_t> q(std::move(lp));
+  assert(q.get().home() == 1);
+  q.push(0);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char* argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       small-object allocation throughput (single process)
+ *
+ * Each thread keeps a window of live blocks of mixed sizes, repeatedly
+ * freeing the oldest block and allocating a fresh one, either by the
+ * SlabAllocator or by the system malloc.
+ * Per-class statistics of the SlabAllocator are reported at the end.
+ *
+ * usage: alloc_throughput [max threads] [seconds per run]
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gam/SlabAllocator.hpp"
+
+/* sizes of typical small objects and control blocks */
+static const size_t sizes[] = {24, 48, 64, 112, 200, 1000};
+constexpr unsigned n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+constexpr unsigned window = 64;
+
+/*
+ *******************************************************************************
+ *
+ * allocators under test
+ *
+ *******************************************************************************
+ */
+struct system_malloc {
+  static void *allocate(size_t size) { return ::malloc(size); }
+  static void deallocate(void *p, size_t) { ::free(p); }
+};
+
+struct slab {
+  static void *allocate(size_t size) {
+    return gam::SlabAllocator::instance().allocate(
+        gam::SlabAllocator::size_class(size));
+  }
+  static void deallocate(void *p, size_t size) {
+    gam::SlabAllocator::instance().deallocate(
+        p, gam::SlabAllocator::size_class(size));
+  }
+};
+
+/*
+ *******************************************************************************
+ *
+ * benchmark kernel
+ *
+ *******************************************************************************
+ */
+static std::atomic<bool> stop;
+
+template <typename Alloc>
+void worker(unsigned long long &ops) {
+  unsigned long long cnt = 0;
+  void *live[window];
+  size_t live_size[window];
+  for (unsigned i = 0; i < window; ++i) {
+    live_size[i] = sizes[i % n_sizes];
+    live[i] = Alloc::allocate(live_size[i]);
+  }
+
+  unsigned next = 0, s = 0;
+  while (!stop.load(std::memory_order_relaxed)) {
+    for (unsigned i = 0; i < 1024; ++i) {
+      Alloc::deallocate(live[next], live_size[next]);
+      live_size[next] = sizes[s];
+      live[next] = Alloc::allocate(sizes[s]);
+      *(volatile char *)live[next] = 0;  // touch
+      next = (next + 1) % window;
+      s = (s + 1) % n_sizes;
+    }
+    cnt += 1024;
+  }
+
+  for (unsigned i = 0; i < window; ++i)
+    Alloc::deallocate(live[i], live_size[i]);
+  ops = cnt;
+}
+
+template <typename Alloc>
+double run(unsigned nthreads, double secs) {
+  std::vector<std::thread> threads;
+  std::vector<unsigned long long> ops(nthreads);
+
+  stop = false;
+  for (unsigned t = 0; t < nthreads; ++t)
+    threads.emplace_back(worker<Alloc>, std::ref(ops[t]));
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(secs));
+  stop = true;
+  for (auto &t : threads) t.join();
+
+  unsigned long long tot = 0;
+  for (auto o : ops) tot += o;
+  return tot / secs;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  unsigned max_threads = std::thread::hardware_concurrency();
+  double secs = 1;
+  if (argc > 1) max_threads = atoi(argv[1]);
+  if (argc > 2) secs = atof(argv[2]);
+  if (!max_threads) max_threads = 1;
+
+  std::cout << "threads\tmalloc ops/s\tslab ops/s" << std::endl;
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    std::cout << t << "\t" << run<system_malloc>(t, secs) << "\t"
+              << run<slab>(t, secs) << std::endl;
+
+  std::cout << "\nblock\tallocs\tfrees\tslabs" << std::endl;
+  for (auto &cs : gam::SlabAllocator::instance().stats())
+    if (cs.allocs)
+      std::cout << cs.block_size << "\t" << cs.allocs << "\t" << cs.frees
+                << "\t" << cs.slabs << std::endl;
+
+  return 0;
+}
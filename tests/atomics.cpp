@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       3-executor network updating shared counters atomically
+ *
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+#include "gam.hpp"
+
+constexpr int n_incs = 1000;
+
+/*
+ * all executors increment a shared counter, then elect a leader by
+ * compare-exchange and signal completion
+ */
+void run(gam::atomic_ptr<int64_t> &counter, gam::atomic_ptr<int32_t> &leader,
+         gam::atomic_ptr<uint8_t> &done) {
+  for (int i = 0; i < n_incs; ++i) counter.fetch_add(1);
+
+  int32_t expected = -1;
+  bool won = leader.compare_exchange(expected, (int32_t)gam::rank());
+  assert(won || (expected >= 0 && expected < (int32_t)gam::cardinality()));
+  (void)won;
+
+  done.fetch_add(1);
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto counter = gam::make_atomic<int64_t>(0);
+  auto leader = gam::make_atomic<int32_t>(-1);
+  auto done = gam::make_atomic<uint8_t>();
+  for (gam::executor_id to = 1; to < gam::cardinality(); ++to) {
+    counter.push(to);
+    leader.push(to);
+    done.push(to);
+  }
+
+  run(counter, leader, done);
+
+  /* wait for all the executors */
+  while (done.load() != gam::cardinality())
+    ;
+
+  int64_t total = counter.load();
+  assert(total == (int64_t)n_incs * gam::cardinality());
+  int32_t l = leader.swap(-1);
+  assert(l >= 0 && l < (int32_t)gam::cardinality());
+  assert(leader.load() == -1);
+
+  std::cout << "counter=" << total << " leader=" << l << std::endl;
+  (void)total;
+  (void)l;
+}
+
+void rn() {
+  auto counter = gam::pull_atomic<int64_t>(0);
+  auto leader = gam::pull_atomic<int32_t>(0);
+  auto done = gam::pull_atomic<uint8_t>(0);
+  run(counter, leader, done);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    default:
+      rn();
+      break;
+  }
+
+  return 0;
+}
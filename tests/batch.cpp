@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network exchanging batches of pointers
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+typedef int val_t;
+
+/* larger than a single pap message */
+constexpr int batch_len = 1000;
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  /* create and push a batch of public pointers */
+  std::vector<gam::public_ptr<val_t>> pub;
+  for (int i = 0; i < batch_len; ++i) pub.push_back(gam::make_public<val_t>(i));
+  gam::push_batch(1, pub);
+
+  /* create and push a batch of private pointers */
+  std::vector<gam::private_ptr<val_t>> pvt;
+  for (int i = 0; i < batch_len; ++i)
+    pvt.push_back(gam::make_private<val_t>(i));
+  gam::push_batch(1, pvt);
+  for (size_t i = 0; i < pvt.size(); ++i) assert(pvt[i] == nullptr);
+
+  /* single push after batches */
+  gam::make_private<val_t>(42).push(1);
+}
+
+void r1() {
+  /* pull the public batch in chunks */
+  std::vector<gam::public_ptr<val_t>> pub;
+  while (pub.size() < batch_len) {
+    auto chunk = gam::pull_public_batch<val_t>(0, 100);
+    assert(!chunk.empty() && chunk.size() <= 100);
+    for (auto &p : chunk) pub.push_back(std::move(p));
+  }
+  assert(pub.size() == batch_len);
+  for (int i = 0; i < batch_len; i += 100) assert(*pub[i].local() == i);
+
+  /* pull the private batch */
+  std::vector<gam::private_ptr<val_t>> pvt;
+  while (pvt.size() < batch_len) {
+    auto chunk = gam::pull_private_batch<val_t>(0, batch_len - pvt.size());
+    for (auto &p : chunk) pvt.push_back(std::move(p));
+  }
+  assert(pvt.size() == batch_len);
+  assert(*pvt[7].local() == 7);
+
+  /* single pull */
+  auto q = gam::pull_private<val_t>(0);
+  assert(*q.local() == 42);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char* argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network borrowing public memory
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+using vec_t = std::vector<double>;
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto p = gam::make_public<vec_t>(1 << 20, 0.5);
+
+  /* locally-authored memory is aliased, with no allocation or copy */
+  auto before = gam::memory_usage();
+  auto b = p.borrow();
+  assert(b.is_alias());
+  assert(b->size() == 1 << 20 && (*b)[0] == 0.5);
+  assert(gam::memory_usage().total.objects == before.total.objects);
+
+  auto b2 = p.borrow();
+  assert(b2.get() == b.get());
+  assert(p.use_count() == 3);
+  p.push(1);
+
+  /* the borrowed object survives the last public pointer */
+  auto q = gam::make_public<vec_t>(10, 1.5);
+  auto bq = q.borrow();
+  q.reset();
+  assert((*bq)[9] == 1.5);
+  assert(gam::memory_usage().levels[gam::AL_PUBLIC].objects ==
+         before.levels[gam::AL_PUBLIC].objects + 1);
+  bq = gam::borrowed_ptr<vec_t>();
+  assert(gam::memory_usage().levels[gam::AL_PUBLIC].objects ==
+         before.levels[gam::AL_PUBLIC].objects);
+  (void)before;
+}
+
+void r1() {
+  auto p = gam::pull_public<vec_t>(0);
+
+  /* remotely-authored memory is copied */
+  auto b = p.borrow();
+  assert(!b.is_alias());
+  assert(b->size() == 1 << 20 && (*b)[0] == 0.5);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
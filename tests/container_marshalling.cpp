@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network transferring standard containers
+ *
+ */
+
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "gam.hpp"
+
+/*
+ *******************************************************************************
+ *
+ * reference values
+ *
+ *******************************************************************************
+ */
+using index_t = std::map<std::string, std::vector<double>>;
+using record_t = std::tuple<int, std::string, std::array<std::string, 2>>;
+using table_t = std::unordered_map<int, std::vector<std::string>>;
+
+std::vector<int> make_vector() {
+  std::vector<int> res(100000);
+  for (size_t i = 0; i < res.size(); ++i) res[i] = (int)i;
+  return res;
+}
+
+index_t make_index() {
+  index_t res;
+  for (int i = 0; i < 10; ++i)
+    res["key" + std::to_string(i)] = std::vector<double>(i, i * 0.5);
+  return res;
+}
+
+record_t make_record() { return record_t{42, "record", {{"first", ""}}}; }
+
+table_t make_table() {
+  table_t res;
+  for (int i = 0; i < 10; ++i)
+    res[i] = std::vector<std::string>(i, std::to_string(i));
+  return res;
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto v = gam::make_public<std::vector<int>>(make_vector());
+  v.push(1);
+
+  auto s = gam::make_private<std::string>("a private string");
+  s.push(1);
+
+  auto m = gam::make_public<index_t>(make_index());
+  m.push(1);
+
+  auto r = gam::make_public<record_t>(make_record());
+  r.push(1);
+
+  auto t = gam::make_private<table_t>(make_table());
+  t.push(1);
+
+  auto b = gam::make_public<std::vector<bool>>(3, true);
+  b.push(1);
+}
+
+void r1() {
+  auto v = gam::pull_public<std::vector<int>>(0);
+  assert(*v.local() == make_vector());
+
+  auto s = gam::pull_private<std::string>(0);
+  assert(*s.local() == "a private string");
+
+  auto m = gam::pull_public<index_t>(0);
+  assert(*m.local() == make_index());
+
+  auto r = gam::pull_public<record_t>(0);
+  assert(*r.local() == make_record());
+
+  auto t = gam::pull_private<table_t>(0);
+  assert(*t.local() == make_table());
+
+  auto b = gam::pull_public<std::vector<bool>>(0);
+  assert(*b.local() == std::vector<bool>(3, true));
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
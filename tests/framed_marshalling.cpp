@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network transferring records by framed marshalling
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gam.hpp"
+
+/*
+ *******************************************************************************
+ *
+ * type definition
+ *
+ *******************************************************************************
+ */
+/*
+ * A record marshalled as four entries, the size of each variable-length
+ * field preceding its payload.
+ */
+struct record {
+  std::string name;
+  std::vector<double> values;
+
+  record() {}
+
+  record(const std::string &name, size_t n) : name(name), values(n) {
+    for (size_t i = 0; i < n; ++i) values[i] = i * 0.5;
+  }
+
+  template <typename StreamInF>
+  void ingest(StreamInF &&f) {
+    f(&name_size, sizeof(size_t));
+    name.resize(name_size);
+    f(&name[0], name_size);
+    f(&values_size, sizeof(size_t));
+    values.resize(values_size);
+    f(values.data(), values_size * sizeof(double));
+  }
+
+  gam::marshalled_t marshall() {
+    gam::marshalled_t res;
+    name_size = name.size();
+    values_size = values.size();
+    res.emplace_back(&name_size, sizeof(size_t));
+    res.emplace_back(&name[0], name_size);
+    res.emplace_back(&values_size, sizeof(size_t));
+    res.emplace_back(values.data(), values_size * sizeof(double));
+    return res;
+  }
+
+  bool check(const std::string &name_, size_t n) const {
+    if (name != name_ || values.size() != n) return false;
+    for (size_t i = 0; i < n; ++i)
+      if (values[i] != i * 0.5) return false;
+    return true;
+  }
+
+ private:
+  size_t name_size = 0, values_size = 0;
+};
+
+namespace gam {
+template <>
+struct framed_marshalling<record> : std::true_type {};
+}  // namespace gam
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto p = gam::make_public<record>("public", 1000);
+  p.push(1);
+
+  auto q = gam::make_private<record>("private", 10);
+  q.push(1);
+
+  /* empty fields marshall into zero-sized entries */
+  auto e = gam::make_public<record>("", 0);
+  e.push(1);
+}
+
+void r1() {
+  auto p = gam::pull_public<record>(0);
+  assert(p.local()->check("public", 1000));
+
+  auto q = gam::pull_private<record>(0);
+  assert(q.local()->check("private", 10));
+
+  auto e = gam::pull_public<record>(0);
+  assert(e.local()->check("", 0));
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
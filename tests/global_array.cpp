@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       3-executor network accessing partitioned arrays
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+constexpr size_t N = 1000;
+constexpr gam::executor_id NP = 3;
+
+int value_of(size_t i) { return 2 * (int)i + 1; }
+
+/* every executor stores its slice by a single bulk put */
+void fill(gam::global_array<int> &a) {
+  size_t lo = gam::rank() * N / NP, hi = (gam::rank() + 1) * N / NP;
+  std::vector<int> src;
+  for (size_t i = lo; i < hi; ++i) src.push_back(value_of(i));
+  size_t stored = a.put(lo, hi, src.data());
+  assert(stored == hi - lo);
+  (void)stored;
+}
+
+void check(gam::global_array<int> &a) {
+  std::vector<int> dst(N + 10);
+  size_t loaded = a.get(0, N + 10, dst.data());  // clipped
+  assert(loaded == N);
+  for (size_t i = 1; i < N; ++i) assert(dst[i] == value_of(i));
+  assert(a.get(N - 1) == value_of(N - 1));
+  (void)loaded;
+}
+
+void check_local(gam::global_array<int> &a) {
+  a.local_partition([&](int *part, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+      size_t i = a.global_index(j);
+      assert(a.owner(i) == gam::rank());
+      assert(part[j] == (i ? value_of(i) : -1));
+      (void)i;
+    }
+  });
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  std::vector<gam::global_array<int>> arrays;
+  arrays.push_back(gam::make_global_array<int>(N));
+  arrays.push_back(gam::make_global_array<int>(N, gam::DIST_CYCLIC));
+  arrays.push_back(gam::make_global_array<int>(N, gam::DIST_BLOCK_CYCLIC, 7));
+  for (auto &a : arrays) {
+    assert(a.size() == N);
+    a.push(1);
+    a.push(2);
+    fill(a);
+  }
+
+  /* wait for the other slices */
+  gam::pull_public<int>(1);
+  gam::pull_public<int>(2);
+
+  for (auto &a : arrays) {
+    check(a);
+    a.put(0, -1);  // owned by 0 for any distribution
+    assert(a.get(0) == -1);
+    check_local(a);
+  }
+
+  gam::make_public<int>(0).push(1);
+  gam::make_public<int>(0).push(2);
+  std::cout << "global arrays ok" << std::endl;
+}
+
+void rn() {
+  std::vector<gam::global_array<int>> arrays;
+  for (int k = 0; k < 3; ++k) {
+    arrays.push_back(gam::pull_global_array<int>(0));
+    fill(arrays.back());
+  }
+  gam::make_public<int>(0).push(0);
+
+  /* wait for checks by 0 */
+  gam::pull_public<int>(0);
+  for (auto &a : arrays) check_local(a);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  assert(gam::cardinality() == NP);
+
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    default:
+      rn();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       3-executor network accessing a partitioned hash map
+ *
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gam.hpp"
+
+using map_t = gam::global_unordered_map<uint64_t, std::string>;
+
+constexpr uint64_t N = 300;
+constexpr gam::executor_id NP = 3;
+
+std::string value_of(uint64_t k) { return "v" + std::to_string(k); }
+
+/* every executor inserts its keys, half one by one and half by batch */
+void fill(map_t &m) {
+  std::vector<std::pair<uint64_t, std::string>> batch;
+  for (uint64_t k = gam::rank(); k < N; k += NP) {
+    if (k % 2) {
+      bool inserted = m.insert(k, value_of(k));
+      assert(inserted);
+      (void)inserted;
+    } else
+      batch.emplace_back(k, value_of(k));
+  }
+  size_t inserted = m.insert(batch);
+  assert(inserted == batch.size());
+  (void)inserted;
+}
+
+/* keys below N / 2 are erased by 0 */
+void check(map_t &m) {
+  std::vector<uint64_t> keys;
+  for (uint64_t k = 0; k < N; ++k) keys.push_back(k);
+  auto found = m.find(keys);
+  assert(found.size() == N);
+  for (uint64_t k = 0; k < N; ++k) {
+    assert(found[k].first == (k >= N / 2));
+    assert(!found[k].first || found[k].second == value_of(k));
+  }
+}
+
+void barrier_to_0() {
+  if (gam::rank()) {
+    gam::make_public<int>(0).push(0);
+    gam::pull_public<int>(0);
+  } else {
+    for (gam::executor_id r = 1; r < NP; ++r) gam::pull_public<int>(r);
+    for (gam::executor_id r = 1; r < NP; ++r) gam::make_public<int>(0).push(r);
+  }
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0(map_t &m) {
+  std::string v;
+  bool found = false;
+  size_t n = 0;
+
+  /* single-key operations */
+  for (uint64_t k = 0; k < N; ++k) {
+    found = m.find(k, v);
+    assert(found && v == value_of(k));
+  }
+  assert(!m.find(N, v));
+  assert(!m.insert(1, "other"));
+  assert(m.find(1, v) && v == value_of(1));
+  assert(!m.insert_or_assign(1, "other"));
+  assert(m.find(1, v) && v == "other");
+  assert(m.insert_or_assign(1, value_of(1)) == false);
+
+  /* read cache */
+  m.cache_capacity(8);
+  for (int i = 0; i < 2; ++i)
+    for (uint64_t k = 0; k < 16; ++k) {
+      found = m.find(k, v);
+      assert(found && v == value_of(k));
+    }
+  n = m.erase(2);
+  assert(n == 1);
+  assert(!m.find(2, v));  // dropped from the cache
+
+  /* batched erase, of the lower half */
+  std::vector<uint64_t> keys;
+  for (uint64_t k = 0; k < N / 2; ++k) keys.push_back(k);
+  n = m.erase(keys);
+  assert(n == N / 2 - 1);
+  m.invalidate_cache();
+  check(m);
+
+  (void)found;
+  (void)n;
+  std::cout << "global unordered map ok" << std::endl;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  assert(gam::cardinality() == NP);
+
+  map_t m;
+  if (gam::rank() == 0) {
+    m = gam::make_global_unordered_map<uint64_t, std::string>();
+    for (gam::executor_id r = 1; r < NP; ++r) m.push(r);
+  } else
+    m = gam::pull_global_unordered_map<uint64_t, std::string>(0);
+
+  fill(m);
+  barrier_to_0();
+
+  /* rank-specific code */
+  if (gam::rank() == 0) r0(m);
+  barrier_to_0();
+  if (gam::rank()) check(m);
+
+  return 0;
+}
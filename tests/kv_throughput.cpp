@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       YCSB-like throughput of a global unordered map
+ *
+ * Every executor loads its share of the records, then runs the core YCSB
+ * workloads for a fixed time each, on zipfian-distributed keys:
+ * - A: 50% reads, 50% updates
+ * - B: 95% reads, 5% updates
+ * - C: 100% reads
+ * Aggregate throughput is reported by executor 0; scaling is measured by
+ * running with growing executor counts (see the bench-kv make target).
+ *
+ * usage: kv_throughput [records] [seconds per workload] [batch] [cache]
+ * - batch: keys per operation, served by batched operations if above 1
+ * - cache: capacity of the read cache of each executor, 0 for none
+ *
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gam.hpp"
+
+using map_t = gam::global_unordered_map<uint64_t, std::string>;
+
+constexpr size_t value_size = 100;
+
+/*
+ *******************************************************************************
+ *
+ * key generation
+ *
+ *******************************************************************************
+ */
+/*
+ * zipfian ranks in [0, n), theta = 0.99 as in YCSB (Gray et al., "Quickly
+ * Generating Billion-Record Synthetic Databases"), scrambled so that hot
+ * keys are spread among owners
+ */
+class zipfian {
+ public:
+  zipfian(uint64_t n, uint64_t seed) : n(n), x(seed * 2654435761ULL + 1) {
+    double zeta2 = 0;
+    for (uint64_t i = 1; i <= n; ++i) zetan += 1 / std::pow((double)i, theta);
+    for (uint64_t i = 1; i <= 2; ++i) zeta2 += 1 / std::pow((double)i, theta);
+    alpha = 1 / (1 - theta);
+    eta = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+  }
+
+  uint64_t next() {
+    double u = uniform(), uz = u * zetan, rank;
+    if (uz < 1)
+      rank = 0;
+    else if (uz < 1 + std::pow(0.5, theta))
+      rank = 1;
+    else
+      rank = n * std::pow(eta * u - eta + 1, alpha);
+    return scramble(std::min((uint64_t)rank, n - 1)) % n;
+  }
+
+  double uniform() {
+    /* xorshift */
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return (x >> 11) * (1.0 / (1ULL << 53));
+  }
+
+ private:
+  static constexpr double theta = 0.99;
+  uint64_t n, x;
+  double zetan = 0, alpha, eta;
+
+  static uint64_t scramble(uint64_t v) {
+    /* FNV-1a of the bytes of v */
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < 8; ++i, v >>= 8)
+      h = (h ^ (v & 0xff)) * 1099511628211ULL;
+    return h;
+  }
+};
+
+/*
+ *******************************************************************************
+ *
+ * benchmark kernel
+ *
+ *******************************************************************************
+ */
+static volatile size_t sink;  // defeats dead-code elimination
+
+void barrier() {
+  if (gam::rank()) {
+    gam::make_public<int>(0).push(0);
+    gam::pull_public<int>(0);
+  } else {
+    for (gam::executor_id r = 1; r < gam::cardinality(); ++r)
+      gam::pull_public<int>(r);
+    for (gam::executor_id r = 1; r < gam::cardinality(); ++r)
+      gam::make_public<int>(0).push(r);
+  }
+}
+
+/* aggregate throughput, at executor 0 */
+double reduce(double ops) {
+  if (gam::rank()) {
+    gam::make_public<double>(ops).push(0);
+    return 0;
+  }
+  for (gam::executor_id r = 1; r < gam::cardinality(); ++r)
+    ops += *gam::pull_public<double>(r).local();
+  return ops;
+}
+
+void load(map_t &m, uint64_t records, size_t batch) {
+  std::vector<std::pair<uint64_t, std::string>> kvs;
+  for (uint64_t k = gam::rank(); k < records; k += gam::cardinality()) {
+    kvs.emplace_back(k, std::string(value_size, 'a' + k % 26));
+    if (kvs.size() == std::max(batch, (size_t)64)) {
+      m.insert(kvs);
+      kvs.clear();
+    }
+  }
+  if (!kvs.empty()) m.insert(kvs);
+}
+
+double run(map_t &m, uint64_t records, double read_ratio, double secs,
+           size_t batch, size_t cache) {
+  zipfian keys(records, gam::rank());
+  std::string v(value_size, 'u'), found;
+  std::vector<uint64_t> reads;
+  std::vector<std::pair<uint64_t, std::string>> updates;
+  m.invalidate_cache();
+  m.cache_capacity(cache);
+  barrier();
+
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  auto end = start + std::chrono::duration<double>(secs);
+  size_t cnt = 0, acc = 0;
+  while (clock::now() < end) {
+    for (unsigned i = 0; i < 16; ++i) {
+      reads.clear();
+      updates.clear();
+      for (size_t b = 0; b < batch; ++b) {
+        uint64_t k = keys.next();
+        if (keys.uniform() < read_ratio)
+          reads.push_back(k);
+        else
+          updates.emplace_back(k, v);
+      }
+      if (batch == 1) {
+        if (!reads.empty()) acc += m.find(reads[0], found);
+        if (!updates.empty())
+          m.insert_or_assign(updates[0].first, updates[0].second);
+      } else {
+        if (!reads.empty()) acc += m.find(reads).size();
+        if (!updates.empty()) m.insert_or_assign(updates);
+      }
+      cnt += batch;
+    }
+  }
+  sink = acc;
+
+  /* the last round overruns the deadline, thus measure the elapsed time */
+  std::chrono::duration<double> elapsed = clock::now() - start;
+  double res = reduce(cnt / elapsed.count());
+  barrier();
+  return res;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  uint64_t records = 100000;
+  double secs = 2;
+  size_t batch = 1, cache = 0;
+  if (argc > 1) records = atoll(argv[1]);
+  if (argc > 2) secs = atof(argv[2]);
+  if (argc > 3) batch = atoi(argv[3]);
+  if (argc > 4) cache = atoi(argv[4]);
+  if (!records) records = 1;
+  if (!batch) batch = 1;
+
+  map_t m;
+  if (gam::rank() == 0) {
+    m = gam::make_global_unordered_map<uint64_t, std::string>();
+    for (gam::executor_id r = 1; r < gam::cardinality(); ++r) m.push(r);
+  } else
+    m = gam::pull_global_unordered_map<uint64_t, std::string>(0);
+
+  load(m, records, batch);
+
+  const std::pair<const char *, double> workloads[] = {
+      {"A", 0.5}, {"B", 0.95}, {"C", 1}};
+  if (gam::rank() == 0)
+    std::cout << "executors\tworkload\tbatch\tcache\tops/s" << std::endl;
+  for (auto &w : workloads) {
+    double ops = run(m, records, w.second, secs, batch, cache);
+    if (gam::rank() == 0)
+      std::cout << gam::cardinality() << "\t" << w.first << "\t" << batch
+                << "\t" << cache << "\t" << ops << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network loading public memory into user buffers
+ *
+ */
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+constexpr int n_rounds = 8;
+constexpr int n_ints = 1024;
+
+using block_t = std::array<int, n_ints>;
+
+block_t make_block(int r) {
+  block_t res;
+  for (int i = 0; i < n_ints; ++i) res[i] = r * n_ints + i;
+  return res;
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  for (int r = 0; r < n_rounds; ++r) {
+    auto p = gam::make_public<block_t>(make_block(r));
+
+    /* load by the author */
+    block_t b;
+    p.load_into(b);
+    assert(b == make_block(r));
+
+    p.push(1);
+
+    auto q = gam::make_public<std::vector<int>>(r * 100, r);
+    q.push(1);
+  }
+}
+
+void r1() {
+  /* reusable buffers */
+  block_t b;
+  std::vector<char> raw(sizeof(block_t) + 1);
+  std::vector<int> v;
+
+  for (int r = 0; r < n_rounds; ++r) {
+    auto p = gam::pull_public<block_t>(0);
+    p.load_into(b);
+    assert(b == make_block(r));
+
+    /* unaligned raw buffer */
+    size_t loaded = p.load_into(raw.data() + 1, sizeof(block_t));
+    assert(loaded == sizeof(block_t));
+    assert(!memcmp(raw.data() + 1, make_block(r).data(), sizeof(block_t)));
+
+    /* short buffer */
+    loaded = p.load_into(raw.data(), sizeof(block_t) - 1);
+    assert(loaded == 0);
+    (void)loaded;
+
+    /* ingest into a previously loaded vector */
+    auto q = gam::pull_public<std::vector<int>>(0);
+    q.load_into(v);
+    assert(v == std::vector<int>(r * 100, r));
+  }
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
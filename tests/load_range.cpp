@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network loading slices of public arrays
+ *
+ */
+
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+constexpr size_t n_elems = 1 << 20;
+constexpr size_t slice = 1000;
+
+using array_t = std::vector<double>;
+using block_t = std::array<int, 64>;
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  array_t a(n_elems);
+  for (size_t i = 0; i < n_elems; ++i) a[i] = i;
+  auto p = gam::make_public<array_t>(a);
+
+  /* local slice */
+  std::vector<double> buf(slice);
+  size_t loaded =
+      p.load_range(10 * sizeof(double), slice * sizeof(double), buf.data());
+  assert(loaded == slice * sizeof(double));
+  assert(buf[0] == 10 && buf[slice - 1] == 10 + slice - 1);
+  (void)loaded;
+
+  p.push(1);
+
+  block_t b;
+  for (int i = 0; i < 64; ++i) b[i] = -i;
+  auto q = gam::make_public<block_t>(b);
+  q.push(1);
+}
+
+void r1() {
+  auto p = gam::pull_public<array_t>(0);
+  assert(p.payload_size() == n_elems * sizeof(double));
+
+  /* remote slices */
+  std::vector<double> buf(slice);
+  for (size_t first = 0; first < n_elems; first += n_elems / 8) {
+    size_t loaded = p.load_range(first * sizeof(double),
+                                 slice * sizeof(double), buf.data());
+    assert(loaded == slice * sizeof(double));
+    for (size_t i = 0; i < slice; ++i) assert(buf[i] == first + i);
+    (void)loaded;
+  }
+
+  /* ranges are clipped at the end of the payload */
+  size_t tail = p.load_range((n_elems - 10) * sizeof(double),
+                             slice * sizeof(double), buf.data());
+  assert(tail == 10 * sizeof(double) && buf[9] == n_elems - 1);
+  tail = p.load_range(n_elems * sizeof(double), 8, buf.data());
+  assert(tail == 0);
+  (void)tail;
+
+  /* trivially-copyable objects are their own payload */
+  auto q = gam::pull_public<block_t>(0);
+  int x[2];
+  size_t loaded = q.load_range(10 * sizeof(int), sizeof(x), x);
+  assert(loaded == sizeof(x) && x[0] == -10 && x[1] == -11);
+  (void)loaded;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
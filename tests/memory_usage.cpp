@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network sampling local memory usage
+ *
+ */
+
+#include <cassert>
+#include <iostream>
+
+#include "gam.hpp"
+
+typedef int val_t;
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto before = gam::memory_usage();
+
+  /* committed objects are accounted by access level */
+  auto p = gam::make_public<val_t>(42);
+  auto q = gam::make_private<val_t>(43);
+  auto during = gam::memory_usage();
+  assert(during.levels[gam::AL_PUBLIC].objects ==
+         before.levels[gam::AL_PUBLIC].objects + 1);
+  assert(during.levels[gam::AL_PRIVATE].objects ==
+         before.levels[gam::AL_PRIVATE].objects + 1);
+  assert(during.total.objects > before.total.objects);
+
+  p.push(1);
+  q.reset();
+  auto after = gam::memory_usage();
+  assert(after.levels[gam::AL_PRIVATE].objects ==
+         before.levels[gam::AL_PRIVATE].objects);
+
+  gam::Accounting::print(std::cout, after);
+}
+
+void r1() {
+  auto p = gam::pull_public<val_t>(0);
+
+  /* local copies are accounted by author */
+  {
+    auto lp = p.local();
+    assert(*lp == 42);
+    auto usage = gam::memory_usage();
+    assert(usage.authors.size() == gam::cardinality());
+    assert(usage.authors[0].objects == 1);
+  }
+  assert(gam::memory_usage().authors[0].objects == 0);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char* argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
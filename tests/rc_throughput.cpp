@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *
+ * @brief       reference counting throughput under contention (single process)
+ *
+ * Each operation increments and then decrements the counter of a random
+ * address, either on the MemoryController or on a reference table made of a
+ * mutex-protected unordered_map.
+ *
+ * usage: rc_throughput [max threads] [seconds per run] [addresses]
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gam/MemoryController.hpp"
+
+/*
+ *******************************************************************************
+ *
+ * reference table
+ *
+ *******************************************************************************
+ */
+class LockedCounts {
+ public:
+  void rc_init(uint64_t a) {
+    std::lock_guard<std::mutex> lg(mtx);
+    ref_cnt[a] = 1;
+  }
+
+  unsigned long long rc_inc(uint64_t a) {
+    std::lock_guard<std::mutex> lg(mtx);
+    return ++ref_cnt[a];
+  }
+
+  unsigned long long rc_dec(uint64_t a) {
+    std::lock_guard<std::mutex> lg(mtx);
+    return --ref_cnt[a];
+  }
+
+ private:
+  std::unordered_map<uint64_t, unsigned long long> ref_cnt;
+  std::mutex mtx;
+};
+
+/*
+ *******************************************************************************
+ *
+ * benchmark kernel
+ *
+ *******************************************************************************
+ */
+static std::atomic<bool> stop;
+static volatile unsigned long long sink;  // defeats dead-code elimination
+
+template <typename Table>
+void worker(Table &table, unsigned seed, uint64_t addresses,
+            unsigned long long &ops) {
+  unsigned long long cnt = 0, x = seed + 1, acc = 0;
+  while (!stop.load(std::memory_order_relaxed)) {
+    for (unsigned i = 0; i < 1024; ++i) {
+      /* xorshift */
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      uint64_t a = gam::GlobalPointer(0, 1 + x % addresses).address();
+      acc += table.rc_inc(a);
+      acc += table.rc_dec(a);
+    }
+    cnt += 2048;
+  }
+  sink = acc;
+  ops = cnt;
+}
+
+template <typename Table>
+double run(unsigned nthreads, double secs, uint64_t addresses) {
+  Table table;
+  for (uint64_t i = 1; i <= addresses; ++i)
+    table.rc_init(gam::GlobalPointer(0, i).address());
+
+  std::vector<std::thread> threads;
+  std::vector<unsigned long long> ops(nthreads);
+
+  stop = false;
+  for (unsigned t = 0; t < nthreads; ++t)
+    threads.emplace_back(worker<Table>, std::ref(table), t, addresses,
+                         std::ref(ops[t]));
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(secs));
+  stop = true;
+  for (auto &t : threads) t.join();
+
+  unsigned long long tot = 0;
+  for (auto o : ops) tot += o;
+  return tot / secs;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  unsigned max_threads = std::thread::hardware_concurrency();
+  double secs = 1;
+  uint64_t addresses = 1 << 16;
+  if (argc > 1) max_threads = atoi(argv[1]);
+  if (argc > 2) secs = atof(argv[2]);
+  if (argc > 3) addresses = atoll(argv[3]);
+  if (!max_threads) max_threads = 1;
+
+  std::cout << "threads\tlocked map ops/s\tcontroller ops/s" << std::endl;
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    std::cout << t << "\t" << run<LockedCounts>(t, secs, addresses) << "\t"
+              << run<gam::MemoryController>(t, secs, addresses) << std::endl;
+
+  return 0;
+}
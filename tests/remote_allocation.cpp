@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network constructing objects on a remote executor
+ *
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+/* constructed from shippable values */
+struct cell {
+  cell() {}
+  cell(int key, double value) : key(key), value(value) {}
+  int key;
+  double value;
+};
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  /* private memory owned here, authored by 1 */
+  auto c = gam::make_private_on<cell>(1, 42, 0.5);
+  assert(c != nullptr);
+  auto lc = c.local();  // moves the object here
+  assert(lc->key == 42 && lc->value == 0.5);
+
+  /* public memory authored by 1, loaded here then by the author */
+  auto v = gam::make_public_on<std::vector<int>>(1, (size_t)1000, 7);
+  assert(v != nullptr);
+  auto lv = v.local();
+  assert(lv->size() == 1000 && (*lv)[999] == 7);
+  v.push(1);
+
+  /* constructing on self falls back to local construction */
+  auto s = gam::make_private_on<cell>(0, 1, 1.0);
+  auto ls = s.local();
+  assert(ls->key == 1);
+
+  std::cout << "remote allocation ok" << std::endl;
+}
+
+void r1() {
+  auto v = gam::pull_public<std::vector<int>>(0);
+  auto lv = v.local();
+  assert(lv->size() == 1000 && (*lv)[0] == 7);
+  (void)lv;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
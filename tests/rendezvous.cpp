@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network loading objects above the rendezvous
+ *              threshold, by any load path
+ *
+ */
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+constexpr size_t n_block = (size_t)1 << 16;  // 256 KiB of words
+constexpr size_t n_words = (size_t)1 << 18;  // 1 MiB of words
+
+using block_t = std::array<uint32_t, n_block>;  // trivially copyable
+using words_t = std::vector<uint32_t>;          // framed
+
+uint32_t word_at(size_t i, uint32_t seed) { return (uint32_t)(i * 7 + seed); }
+
+template <typename C>
+void fill(C &c, uint32_t seed) {
+  for (size_t i = 0; i < c.size(); ++i) c[i] = word_at(i, seed);
+}
+
+block_t make_block(uint32_t seed) {
+  block_t res;
+  fill(res, seed);
+  return res;
+}
+
+template <typename C>
+bool check(const C &c, uint32_t seed) {
+  for (size_t i = 0; i < c.size(); ++i)
+    if (c[i] != word_at(i, seed)) return false;
+  return true;
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  auto b = gam::make_public<block_t>(make_block(1));
+  b.push(1);
+
+  words_t w(n_words);
+  fill(w, 2);
+  gam::make_public<words_t>(std::move(w)).push(1);  // held by the peer only
+
+  auto pb = gam::make_private<block_t>(make_block(3));
+  pb.push(1);
+}
+
+void r1() {
+  auto b = gam::pull_public<block_t>(0);
+  bool ok = check(*b.local(), 1);
+  assert(ok);
+
+  /* raw loads */
+  std::vector<block_t> buf(1);
+  b.load_into(buf[0]);
+  ok = check(buf[0], 1);
+  assert(ok);
+
+  /* whole framed object, then a sub-range of its payload */
+  auto w = gam::pull_public<words_t>(0);
+  ok = w.local()->size() == n_words && check(*w.local(), 2);
+  assert(ok);
+
+  words_t part(n_words / 2);
+  size_t offset = n_words / 4 * sizeof(uint32_t);
+  size_t loaded = w.load_range(offset, part.size() * sizeof(uint32_t),  //
+                               part.data());
+  assert(loaded == part.size() * sizeof(uint32_t));
+  for (size_t i = 0; i < part.size(); ++i)
+    ok = ok && part[i] == word_at(i + n_words / 4, 2);
+  assert(ok);
+
+  /* ownership transfer of private memory */
+  auto pb = gam::pull_private<block_t>(0);
+  ok = check(*pb.local(), 3);
+  assert(ok);
+
+  (void)ok;
+  (void)loaded;
+  std::cout << "rendezvous loads ok" << std::endl;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network writing through to owned private memory
+ *
+ */
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gam.hpp"
+
+using block_t = std::array<int, 64>;
+
+block_t make_block(int seed) {
+  block_t res;
+  for (size_t i = 0; i < res.size(); ++i) res[i] = seed + (int)i;
+  return res;
+}
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  /* trivially-copyable object authored by 1 */
+  auto b = gam::make_private_on<block_t>(1);
+  b.store(make_block(10));
+  int patch[2] = {-1, -2};
+  size_t stored = b.store(8 * sizeof(int), sizeof(patch), patch);
+  assert(stored == sizeof(patch));
+  stored = b.store(63 * sizeof(int), sizeof(patch), patch);  // clipped
+  assert(stored == sizeof(int));
+
+  /* framed object authored by 1 */
+  auto v = gam::pull_private<std::vector<int>>(1);
+  v.store(std::vector<int>(100, 5));
+  stored = v.store(0, sizeof(patch), patch);
+  assert(stored == sizeof(patch));
+
+  auto s = gam::pull_private<std::string>(1);
+  s.store(std::string("written through"));
+
+  /* locally-authored object */
+  auto l = gam::make_private<block_t>();
+  l.store(make_block(20));
+  stored = l.store(0, sizeof(patch), patch);
+  assert(stored == sizeof(patch));
+
+  /* observe the stores */
+  auto lb = b.local();
+  block_t ref = make_block(10);
+  ref[8] = -1;
+  ref[9] = -2;
+  ref[63] = -1;
+  assert(*lb == ref);
+
+  auto lv = v.local();
+  assert(lv->size() == 100 && (*lv)[0] == -1 && (*lv)[1] == -2 &&
+         (*lv)[99] == 5);
+
+  auto ls = s.local();
+  assert(*ls == "written through");
+
+  auto ll = l.local();
+  assert((*ll)[0] == -1 && (*ll)[2] == 22);
+
+  (void)stored;
+  std::cout << "stores ok" << std::endl;
+}
+
+void r1() {
+  gam::make_private<std::vector<int>>(3, 0).push(0);
+  gam::make_private<std::string>("initial").push(0);
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       2-executor network streaming large public objects
+ *
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "gam.hpp"
+
+constexpr size_t n_bytes = ((size_t)64 << 20) + 3;  // not chunk-aligned
+
+using blob_t = std::vector<uint8_t>;
+
+uint8_t byte_at(size_t i) { return (uint8_t)(i * 7 + 3); }
+
+/*
+ *******************************************************************************
+ *
+ * rank-specific routines
+ *
+ *******************************************************************************
+ */
+void r0() {
+  blob_t b(n_bytes);
+  for (size_t i = 0; i < n_bytes; ++i) b[i] = byte_at(i);
+  auto p = gam::make_public<blob_t>(std::move(b));
+  p.push(1);
+}
+
+void r1() {
+  auto p = gam::pull_public<blob_t>(0);
+
+  /* process chunks as they land, in order */
+  blob_t buf(n_bytes);
+  size_t expected = 0, chunks = 0;
+  uint64_t sum = 0;
+  size_t loaded = p.load_range(0, n_bytes, buf.data(),  //
+                               [&](size_t offset, size_t len) {
+                                 assert(offset == expected);
+                                 for (size_t i = offset; i < offset + len; ++i)
+                                   sum += buf[i];
+                                 expected += len;
+                                 ++chunks;
+                               });
+  assert(loaded == n_bytes && expected == n_bytes);
+  std::cout << "streamed " << loaded << " bytes in " << chunks << " chunks"
+            << std::endl;
+
+  uint64_t ref = 0;
+  for (size_t i = 0; i < n_bytes; ++i) ref += byte_at(i);
+  assert(sum == ref);
+  (void)ref;
+
+  /* whole-object loads are streamed as well */
+  auto lp = p.local();
+  assert(lp->size() == n_bytes && (*lp)[n_bytes - 1] == byte_at(n_bytes - 1));
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  /* rank-specific code */
+  switch (gam::rank()) {
+    case 0:
+      r0();
+      break;
+    case 1:
+      r1();
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 alpha group, CS department, University of Torino.
+ *
+ * This file is part of gam
+ * (see https://github.com/alpha-unito/gam).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *
+ * @brief       View lookup throughput under contention (single process)
+ *
+ * Each operation reads author, access level and committed copy of a random
+ * address, either by three field getters or by a single record lookup.
+ *
+ * usage: view_contention [max threads] [seconds per run] [records]
+ *
+ */
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gam/View.hpp"
+
+/*
+ *******************************************************************************
+ *
+ * benchmark kernel
+ *
+ *******************************************************************************
+ */
+static std::atomic<bool> stop;
+static volatile gam::executor_id sink;  // defeats dead-code elimination
+
+void reader(gam::View &view, bool by_record, unsigned seed, uint64_t records,
+            unsigned long long &ops) {
+  unsigned long long cnt = 0, x = seed + 1;
+  gam::executor_id acc = 0;
+  while (!stop.load(std::memory_order_relaxed)) {
+    for (unsigned i = 0; i < 1024; ++i) {
+      /* xorshift */
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      uint64_t a = gam::GlobalPointer(0, 1 + x % records).address();
+      if (by_record) {
+        gam::View::entry e = view.record(a);
+        acc += e.author + e.access_level + (e.committed != nullptr);
+      } else {
+        acc += view.author(a) + view.access_level(a);
+        acc += (view.committed(a) != nullptr);
+      }
+    }
+    cnt += 1024;
+  }
+  sink = acc;
+  ops = cnt;
+}
+
+double run(gam::View &view, bool by_record, unsigned nthreads, double secs,
+           uint64_t records) {
+  std::vector<std::thread> threads;
+  std::vector<unsigned long long> ops(nthreads);
+
+  stop = false;
+  for (unsigned t = 0; t < nthreads; ++t)
+    threads.emplace_back(reader, std::ref(view), by_record, t, records,
+                         std::ref(ops[t]));
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(secs));
+  stop = true;
+  for (auto &t : threads) t.join();
+
+  unsigned long long tot = 0;
+  for (auto o : ops) tot += o;
+  return tot / secs;
+}
+
+/*
+ *******************************************************************************
+ *
+ * main
+ *
+ *******************************************************************************
+ */
+int main(int argc, char *argv[]) {
+  unsigned max_threads = std::thread::hardware_concurrency();
+  double secs = 1;
+  uint64_t records = 1 << 16;
+  if (argc > 1) max_threads = atoi(argv[1]);
+  if (argc > 2) secs = atof(argv[2]);
+  if (argc > 3) records = atoll(argv[3]);
+  if (!max_threads) max_threads = 1;
+
+  /* populate the view */
+  gam::View view;
+  for (uint64_t i = 1; i <= records; ++i) {
+    uint64_t a = gam::GlobalPointer(0, i).address();
+    view.bind_access_level(a, gam::AL_PUBLIC);
+    view.bind_author(a, 0);
+    view.bind_owner(a, 0);
+    view.bind_child(a, nullptr);
+  }
+
+  std::cout << "threads\tgetters ops/s\trecord ops/s" << std::endl;
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    std::cout << t << "\t" << run(view, false, t, secs, records) << "\t"
+              << run(view, true, t, secs, records) << std::endl;
+
+  return 0;
+}